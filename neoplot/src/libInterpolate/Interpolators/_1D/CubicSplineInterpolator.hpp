@@ -21,8 +21,8 @@ class CubicSplineInterpolator : public InterpolatorBase<CubicSplineInterpolator<
     using MapType = typename BASE::MapType;
 
   protected:
-    // Interpolation coefficients
-    VectorType a,b;
+    // Interpolation coefficients, shared between copies
+    std::shared_ptr<const VectorType> a,b;
 
   public:
 
@@ -45,8 +45,8 @@ class CubicSplineInterpolator : public InterpolatorBase<CubicSplineInterpolator<
     // copy-swap idiom
     friend void swap( CubicSplineInterpolator& lhs, CubicSplineInterpolator& rhs)
     {
-      lhs.a.swap(rhs.a);
-      lhs.b.swap(rhs.b);
+      std::swap( lhs.a, rhs.a );
+      std::swap( lhs.b, rhs.b );
       swap( static_cast<BASE&>(lhs), static_cast<BASE&>(rhs) );
     }
 
@@ -71,6 +71,7 @@ class CubicSplineInterpolator : public InterpolatorBase<CubicSplineInterpolator<
     // from the base class, so we declare the base
     // as a friend (otherwise we would have to make it public)
     void setupInterpolator();
+    Real evaluate_in_interval( Real x, int i ) const;
     friend BASE;
 
 
@@ -87,18 +88,25 @@ CubicSplineInterpolator<Real>::operator()( Real x ) const
   BASE::checkData();
 
   const MapType &X = *(this->xView);
-  const MapType &Y = *(this->yView);
 
   // don't extrapolate at all
   if( x < X(0) || x > X(X.size()-1) )
     return 0;
 
-  int i = this->get_index_to_right_of(x);
+  return evaluate_in_interval(x, this->get_index_to_right_of(x) - 1);
+}
+
+template<class Real>
+Real
+CubicSplineInterpolator<Real>::evaluate_in_interval( Real x, int i ) const
+{
+  const MapType &X = *(this->xView);
+  const MapType &Y = *(this->yView);
 
   // See the wikipedia page on "Spline interpolation" (https://en.wikipedia.org/wiki/Spline_interpolation)
   // for a derivation this interpolation.
-  Real t = ( x - X(i-1) ) / ( X(i) - X(i-1) );
-  Real q = ( 1 - t ) * Y(i-1) + t * Y(i) + t*(1-t)*(a[i-1]*(1-t)+b[i-1]*t);
+  Real t = ( x - X(i) ) / ( X(i+1) - X(i) );
+  Real q = ( 1 - t ) * Y(i) + t * Y(i+1) + t*(1-t)*((*a)[i]*(1-t)+(*b)[i]*t);
   
   return q;
 }
@@ -119,8 +127,8 @@ CubicSplineInterpolator<Real>::derivative( Real x ) const
   //this should be the same t as in the regular interpolation case
   Real t = ( x - X(i-1) ) / ( X(i) - X(i-1) );
 
-  Real qprime = ( Y(i) - Y(i-1) )/( X(i)-X(i-1) ) + ( 1 - 2*t )*( a[i-1]*(1-t) + b[i-1]*t )/( X(i) - X(i-1))
-                  + t*(1-t)*(b[i-1]-a[i-1])/(X(i)-X(i-1)) ;
+  Real qprime = ( Y(i) - Y(i-1) )/( X(i)-X(i-1) ) + ( 1 - 2*t )*( (*a)[i-1]*(1-t) + (*b)[i-1]*t )/( X(i) - X(i-1))
+                  + t*(1-t)*((*b)[i-1]-(*a)[i-1])/(X(i)-X(i-1)) ;
 
   return qprime;
 }
@@ -195,7 +203,7 @@ CubicSplineInterpolator<Real>::integral( Real _a, Real _b ) const
     // X(bi) is to the RIGHT of _b, but i only goes up to bi-2 and
     // X(bi-1) is to the LEFT of _b
     // therefore, we are just handling interior elements in this loop.
-    sum += static_cast<Real>( (x_2 - x_1)*( 0.5*(y_1 + y_2) + (1./12)*(a[i] + b[i]) ) );
+    sum += static_cast<Real>( (x_2 - x_1)*( 0.5*(y_1 + y_2) + (1./12)*((*a)[i] + (*b)[i]) ) );
   }
 
 
@@ -214,7 +222,7 @@ CubicSplineInterpolator<Real>::integral( Real _a, Real _b ) const
   t   = (_b - x_1)/(x_2 - x_1);
 
   // adding area between x_1 and _b
-  sum += static_cast<Real>( (x_2 - x_1) * ( ( t - pow(t,2)/2 )*y_1 + pow(t,2)/2.*y_2 + a[bi-1]*(pow(t,2) - 2.*pow(t,3)/3. + pow(t,4)/4.) + b[bi-1]*(pow(t,3)/3. - pow(t,4)/4.) ) );
+  sum += static_cast<Real>( (x_2 - x_1) * ( ( t - pow(t,2)/2 )*y_1 + pow(t,2)/2.*y_2 + (*a)[bi-1]*(pow(t,2) - 2.*pow(t,3)/3. + pow(t,4)/4.) + (*b)[bi-1]*(pow(t,3)/3. - pow(t,4)/4.) ) );
 
   //
   // [_a,X(0)]
@@ -229,10 +237,10 @@ CubicSplineInterpolator<Real>::integral( Real _a, Real _b ) const
   t   = (_a - x_1)/(x_2 - x_1);
 
   // subtracting area from x_1 to _a
-  sum -= static_cast<Real>( (x_2 - x_1) * ( ( t - pow(t,2)/2 )*y_1 + pow(t,2)/2.*y_2 + a[ai-1]*(pow(t,2) - 2.*pow(t,3)/3. + pow(t,4)/4.) + b[ai-1]*(pow(t,3)/3. - pow(t,4)/4.) ) );
+  sum -= static_cast<Real>( (x_2 - x_1) * ( ( t - pow(t,2)/2 )*y_1 + pow(t,2)/2.*y_2 + (*a)[ai-1]*(pow(t,2) - 2.*pow(t,3)/3. + pow(t,4)/4.) + (*b)[ai-1]*(pow(t,3)/3. - pow(t,4)/4.) ) );
 
   if( ai != bi ) // _a and _b are not in the in the same element, need to add area of element containing _a
-    sum += static_cast<Real>( (x_2 - x_1)*( 0.5*(y_1 + y_2) + (1./12)*(a[ai-1] + b[ai-1]) ) );
+    sum += static_cast<Real>( (x_2 - x_1)*( 0.5*(y_1 + y_2) + (1./12)*((*a)[ai-1] + (*b)[ai-1]) ) );
 
   return sign*sum;
 
@@ -249,8 +257,8 @@ CubicSplineInterpolator<Real>::setupInterpolator()
   const MapType &X = *(this->xView);
   const MapType &Y = *(this->yView);
 
-  this->a = VectorType(X.size()-1);
-  this->b = VectorType(X.size()-1);
+  VectorType new_a(X.size()-1);
+  VectorType new_b(X.size()-1);
 
   // we need to solve A x = b, where A is a matrix and b is a vector...
   // isn't that what we are always doing?
@@ -341,10 +349,13 @@ CubicSplineInterpolator<Real>::setupInterpolator()
 
   for (int i = 0; i < X.size() - 1; ++i)
   {
-      this->a(i) = x(i) * (X(i+1)-X(i)) - (Y(i+1) - Y(i));
-      this->b(i) = -x(i+1) * (X(i+1) - X(i)) + (Y(i+1) - Y(i));
+      new_a(i) = x(i) * (X(i+1)-X(i)) - (Y(i+1) - Y(i));
+      new_b(i) = -x(i+1) * (X(i+1) - X(i)) + (Y(i+1) - Y(i));
   }
 
+  this->a = std::make_shared<const VectorType>(std::move(new_a));
+  this->b = std::make_shared<const VectorType>(std::move(new_b));
+
 }
 
 }
@@ -10,10 +10,13 @@
 #include <memory>
 #include <algorithm>
 #include <type_traits>
+#include <utility>
 #include <vector>
 #include "Eigen/Dense"
 #include<boost/range/algorithm.hpp>
 
+#include "libInterpolate/Utils/Parallel.hpp"
+
 
 namespace _1D {
 
@@ -23,6 +26,10 @@ namespace _1D {
   *
   * This class provides eigen matrices to store the data that is interpolated, a few setData methods
   * to populate the data.
+  *
+  * The data is immutable once it is set and shared between copies of an interpolator, so copying
+  * a configured interpolator, e.g. to hand one to each thread, does not duplicate the data. Setting
+  * new data replaces it in this interpolator only.
   */
 
 template<typename T>
@@ -42,7 +49,7 @@ class InterpolatorBase
   private:
     // we don't want base classes accessing these directly,
     // they should use xView and yView instead.
-    std::vector<Real> xData, yData;        ///< storage for interpolated data
+    std::shared_ptr<const std::vector<Real>> xData, yData; ///< storage for interpolated data, shared with copies
 
   protected:
     std::unique_ptr<MapType> xView, yView; ///< eigen matrix view of the data
@@ -57,12 +64,13 @@ class InterpolatorBase
 
     // copy constructor
     // we only want to initialize x and y views if the object
-    // we are copying from is initialized.
+    // we are copying from is initialized. the data is shared, so
+    // the views can point to the same memory.
     InterpolatorBase(const InterpolatorBase& rhs)
     :xData(rhs.xData)
     ,yData(rhs.yData)
-    ,xView( rhs.xView ? new MapType( xData.data(), xData.size() ) : nullptr )
-    ,yView( rhs.xView ? new MapType( yData.data(), yData.size() ) : nullptr )
+    ,xView( rhs.xView ? new MapType( *rhs.xView ) : nullptr )
+    ,yView( rhs.yView ? new MapType( *rhs.yView ) : nullptr )
     { 
     }
 
@@ -84,10 +92,10 @@ class InterpolatorBase
 
   public:
     // methods to get the data
-    const std::vector<Real>& getXData() const { return xData; }
-    const std::vector<Real>& getYData() const { return yData; }
-    std::vector<Real> getXData() { return xData; }
-    std::vector<Real> getYData() { return yData; }
+    const std::vector<Real>& getXData() const { return xData ? *xData : noData(); }
+    const std::vector<Real>& getYData() const { return yData ? *yData : noData(); }
+    std::vector<Real> getXData() { return std::as_const(*this).getXData(); }
+    std::vector<Real> getYData() { return std::as_const(*this).getYData(); }
 
 
 
@@ -138,16 +146,26 @@ class InterpolatorBase
     template<typename XIter, typename YIter>
     auto
     setData( const XIter &x_begin, const XIter &x_end, const YIter &y_begin, const YIter &y_end)
-    -> decltype(std::copy(x_begin,x_end,xData.begin()),std::copy(y_begin,y_end,yData.begin()),void())
+    -> decltype(std::copy(x_begin,x_end,std::declval<std::vector<Real>&>().begin()),std::copy(y_begin,y_end,std::declval<std::vector<Real>&>().begin()),void())
     {
-      xData.clear();
-      yData.clear();
-      xData.reserve(x_end-x_begin);
-      yData.reserve(y_end-y_begin);
-      std::copy( x_begin, x_end, std::back_inserter(xData) );
-      std::copy( y_begin, y_end, std::back_inserter(yData) );
+      auto x = std::make_shared<std::vector<Real>>();
+      auto y = std::make_shared<std::vector<Real>>();
+      x->reserve(x_end-x_begin);
+      y->reserve(y_end-y_begin);
+      std::copy( x_begin, x_end, std::back_inserter(*x) );
+      std::copy( y_begin, y_end, std::back_inserter(*y) );
+
+      this->setSharedData( std::move(x), std::move(y) );
+    }
 
-      this->setUnsafeDataReference( xData.size(), xData.data(), yData.data() );
+    /**
+     * Set the data that will be interpolated by moving it into the interpolator, without a copy.
+     */
+    void
+    setData( std::vector<Real> &&x, std::vector<Real> &&y )
+    {
+      this->setSharedData( std::make_shared<const std::vector<Real>>(std::move(x)),
+                           std::make_shared<const std::vector<Real>>(std::move(y)) );
     }
 
 
@@ -179,6 +197,20 @@ class InterpolatorBase
     void checkData() const; ///< Check that data has been initialized and throw exception if not.
 
   private:
+    void
+    setSharedData( std::shared_ptr<const std::vector<Real>> x, std::shared_ptr<const std::vector<Real>> y )
+    {
+      xData = std::move(x);
+      yData = std::move(y);
+      this->setUnsafeDataReference( xData->size(), xData->data(), yData->data() );
+    }
+
+    static const std::vector<Real>& noData()
+    {
+      static const std::vector<Real> empty;
+      return empty;
+    }
+
     // callSetupInterpolator will call a function named setupInterpolator in the derived class, if
     // it exists. this is just some template magic to detect if the derived class has implemented a
     // setupInterpolator function, and to call it if it does.
@@ -220,15 +252,97 @@ class InterpolatorBase
     batch( const XIter x_begin, XIter x_end, YIter y_begin) const
     -> decltype( *(y_begin+1)=Real(), *(x_begin+1), void() )
     {
-      int N = x_end-x_begin;
-#pragma omp parallel for
-      for( int i = 0; i < N; ++i)
+      // checked here, as operator() throwing on a worker thread would terminate
+      checkData();
+
+      const int N = static_cast<int>(x_end-x_begin);
+      libInterpolate::Utils::parallel_for(0, N, [&](int i)
       {
         *(y_begin+i) = static_cast<const Derived*>(this)->operator()(*(x_begin+i));
-      }
+      }, parallel_chunk_size);
     }
 
 
+    std::vector<Real> batch_monotone( const std::vector<Real> &xs ) const
+    {
+      std::vector<Real> ys(xs.size());
+      this->batch_monotone(xs.begin(), xs.end(), ys.begin());
+      return ys;
+    }
+
+    /**
+     * Like batch(), but for queries in ascending order. Instead of a binary search per query, a cursor
+     * into the data is advanced from one query to the next, galloping over the data when the queries
+     * are sparse. Queries that are out of order are still correct, they just restart the search.
+     * Requires the derived class to provide evaluate_in_interval(x, i) for X(i) <= x <= X(i+1).
+     */
+    template<typename XIter, typename YIter>
+    auto
+    batch_monotone( const XIter x_begin, XIter x_end, YIter y_begin) const
+    -> decltype( *(y_begin+1)=Real(), *(x_begin+1), void() )
+    {
+      checkData();
+
+      const int N = static_cast<int>(x_end-x_begin);
+      const int num_chunks = std::max(1, N / parallel_chunk_size);
+      libInterpolate::Utils::parallel_for(0, num_chunks, [&](int chunk)
+      {
+        const MapType &X = *(this->xView);
+        const int begin = static_cast<int>(static_cast<long>(N) * chunk / num_chunks);
+        const int end = static_cast<int>(static_cast<long>(N) * (chunk + 1) / num_chunks);
+
+        // every chunk starts its own cursor
+        int i = -1;
+        Real previous = 0;
+        for( int k = begin; k < end; ++k)
+        {
+          const Real x = *(x_begin+k);
+
+          // don't extrapolate at all
+          if( x < X(0) || x > X(X.size()-1) )
+          {
+            *(y_begin+k) = 0;
+            continue;
+          }
+
+          i = i < 0 || x < previous ? std::max(0, this->get_index_to_left_of(x)) : this->advance_interval(i, x);
+          previous = x;
+          *(y_begin+k) = static_cast<const Derived*>(this)->evaluate_in_interval(x, i);
+        }
+      });
+    }
+
+
+  private:
+    // batches smaller than this are not split over threads
+    static constexpr int parallel_chunk_size = 4096;
+
+    /**
+     * Given the interval i of a previous query, returns the interval of x >= X(i) with the same
+     * convention as get_index_to_left_of(). Searches exponentially growing steps to the right of i,
+     * then binary searches within the last step.
+     */
+    int
+    advance_interval(int i, Real x) const
+    {
+      const MapType &X = *(this->xView);
+      const int last = static_cast<int>(X.size())-1;
+
+      // looking for the first j > 0 with X(j) >= x, the interval is j - 1
+      int j = i + 1;
+      if( j >= last || X(j) >= x )
+        return j - 1;
+
+      int step = 1;
+      while( j + step < last && X(j+step) < x )
+        step *= 2;
+
+      const Real *first = X.data() + j + step/2 + 1;
+      const Real *end = X.data() + std::min(j + step, last) + 1;
+      j = std::min( static_cast<int>(std::lower_bound(first, end, x) - X.data()), last );
+      return j - 1;
+    }
+
 };
 
 
@@ -35,9 +35,10 @@ class LinearInterpolator : public InterpolatorBase<LinearInterpolator<Real>>
 
     Real operator()( Real x ) const;
 
+  protected:
 
-
-
+    Real evaluate_in_interval( Real x, int i ) const;
+    friend BASE;
 
 };
 
@@ -48,14 +49,21 @@ LinearInterpolator<Real>::operator()( Real x ) const
   BASE::checkData();
 
   const MapType &X = *(this->xView);
-  const MapType &Y = *(this->yView);
 
   // don't extrapolate at all
   if( x < X(0) || x > X(X.size()-1) )
     return 0;
 
-  int i = this->get_index_to_left_of(x);
-     
+  return evaluate_in_interval(x, this->get_index_to_left_of(x));
+}
+
+template<class Real>
+Real
+LinearInterpolator<Real>::evaluate_in_interval( Real x, int i ) const
+{
+  const MapType &X = *(this->xView);
+  const MapType &Y = *(this->yView);
+
   Real b  = Y(i);
   Real m  = Y(i+1)-Y(i);
        m /= X(i+1)-X(i);
@@ -25,7 +25,8 @@ class MonotonicInterpolator : public InterpolatorBase<MonotonicInterpolator<Real
     using MapType = typename BASE::MapType;
 
   protected:
-    VectorType a,b,yplow,yphigh;
+    // interpolation coefficients, shared between copies
+    std::shared_ptr<const VectorType> a,b,yplow,yphigh;
 
   public:
 
@@ -50,10 +51,10 @@ class MonotonicInterpolator : public InterpolatorBase<MonotonicInterpolator<Real
     // copy-swap idiom
     friend void swap( MonotonicInterpolator& lhs, MonotonicInterpolator& rhs)
     {
-      lhs.a.swap(rhs.a);
-      lhs.b.swap(rhs.b);
-      lhs.yplow.swap(rhs.yplow);
-      lhs.yphigh.swap(rhs.yphigh);
+      std::swap( lhs.a, rhs.a );
+      std::swap( lhs.b, rhs.b );
+      std::swap( lhs.yplow, rhs.yplow );
+      std::swap( lhs.yphigh, rhs.yphigh );
       swap( static_cast<BASE&>(lhs), static_cast<BASE&>(rhs) );
     }
 
@@ -68,6 +69,7 @@ class MonotonicInterpolator : public InterpolatorBase<MonotonicInterpolator<Real
   protected:
 
     void setupInterpolator();
+    Real evaluate_in_interval( Real x, int i ) const;
     friend BASE;
 
 };
@@ -79,10 +81,10 @@ MonotonicInterpolator<Real>::setupInterpolator()
   const MapType &X = *(this->xView);
   const MapType &Y = *(this->yView);
 
-  a      = VectorType(X.size()-1);
-  b      = VectorType(X.size()-1);
-  yplow  = VectorType(X.size()-1);
-  yphigh = VectorType(X.size()-1);
+  VectorType new_a(X.size()-1);
+  VectorType new_b(X.size()-1);
+  VectorType new_yplow(X.size()-1);
+  VectorType new_yphigh(X.size()-1);
 
 
   for(int i = 0; i < X.size()-1; i++)
@@ -103,7 +105,7 @@ MonotonicInterpolator<Real>::setupInterpolator()
     {
       // first interval does not have an interval to its "left", so just
       // use the slope in the interval.
-      yplow[i] = slope;
+      new_yplow[i] = slope;
     }
     else
     {
@@ -115,18 +117,18 @@ MonotonicInterpolator<Real>::setupInterpolator()
       if (slope_low* slope <= 0.0)
       {
         // Set derivative as zero
-        yplow[i] = 0.0;
+        new_yplow[i] = 0.0;
       }
       else
       {
-        yplow[i] = ((slope_low*h) + (slope*hlow))/(hlow + h);
-        if (yplow[i] >= 0.0)
+        new_yplow[i] = ((slope_low*h) + (slope*hlow))/(hlow + h);
+        if (new_yplow[i] >= 0.0)
         {
-          yplow[i] = (std::min)(yplow[i], static_cast<Real>(2.0)*(std::min)(slope_low, slope));
+          new_yplow[i] = (std::min)(new_yplow[i], static_cast<Real>(2.0)*(std::min)(slope_low, slope));
         }
         else
         {
-          yplow[i] = (std::max)(yplow[i], static_cast<Real>(2.0)*(std::max)(slope_low, slope));
+          new_yplow[i] = (std::max)(new_yplow[i], static_cast<Real>(2.0)*(std::max)(slope_low, slope));
         }
       }
     }
@@ -136,7 +138,7 @@ MonotonicInterpolator<Real>::setupInterpolator()
 	{
     // last interval does not have an interval to its "right", so just
     // use the slope in the interval.
-		yphigh[i] = slope;
+		new_yphigh[i] = slope;
 	}
 	else
 	{
@@ -148,31 +150,33 @@ MonotonicInterpolator<Real>::setupInterpolator()
 		if (slope*slope_high <= 0.0)
 		{
 			// Set derivative as zero
-			yphigh[i] = 0.0;
+			new_yphigh[i] = 0.0;
 		}
 		else
 		{
-			yphigh[i] = ((slope*hhigh) + (slope_high*h))/(h + hhigh);
-			if (yphigh[i] >= 0.0)
+			new_yphigh[i] = ((slope*hhigh) + (slope_high*h))/(h + hhigh);
+			if (new_yphigh[i] >= 0.0)
 			{
-				yphigh[i] = (std::min)(yphigh[i], static_cast<Real>(2.0)*(std::min)(slope, slope_high));
+				new_yphigh[i] = (std::min)(new_yphigh[i], static_cast<Real>(2.0)*(std::min)(slope, slope_high));
 			}
 			else
 			{
-				yphigh[i] = (std::max)(yphigh[i], static_cast<Real>(2.0)*(std::max)(slope, slope_high));
+				new_yphigh[i] = (std::max)(new_yphigh[i], static_cast<Real>(2.0)*(std::max)(slope, slope_high));
 			}
 		}
 	}
 
-  a[i] = (yplow[i] + yphigh[i] - (2.0*slope))/(h*h);
-	b[i] = ((3.0*slope) + (-2.0*yplow[i]) - yphigh[i])/h;
+  new_a[i] = (new_yplow[i] + new_yphigh[i] - (2.0*slope))/(h*h);
+	new_b[i] = ((3.0*slope) + (-2.0*new_yplow[i]) - new_yphigh[i])/h;
 
 
 
   }
 
-
-
+  a      = std::make_shared<const VectorType>(std::move(new_a));
+  b      = std::make_shared<const VectorType>(std::move(new_b));
+  yplow  = std::make_shared<const VectorType>(std::move(new_yplow));
+  yphigh = std::make_shared<const VectorType>(std::move(new_yphigh));
 }
 
 template<class Real>
@@ -182,7 +186,6 @@ MonotonicInterpolator<Real>::operator()( Real x ) const
   BASE::checkData();
 
   const MapType &X = *(this->xView);
-  const MapType &Y = *(this->yView);
 
   // don't extrapolate at all
   if( x < X(0) || x > X(X.size()-1) )
@@ -190,7 +193,15 @@ MonotonicInterpolator<Real>::operator()( Real x ) const
 
 
   // the index that is just to the left of x will correspond to the "interval index"
-  int i = this->get_index_to_left_of(x);
+  return evaluate_in_interval(x, this->get_index_to_left_of(x));
+}
+
+template<class Real>
+Real
+MonotonicInterpolator<Real>::evaluate_in_interval( Real x, int i ) const
+{
+  const MapType &X = *(this->xView);
+  const MapType &Y = *(this->yView);
 
 	// Deal with the degenerate case of xval = xlow = xhigh
 	if (X(i+1) <= X(i))
@@ -198,7 +209,7 @@ MonotonicInterpolator<Real>::operator()( Real x ) const
 
 	Real xm = x - X(i);
 	Real xm2 = xm*xm;
-	Real f = (a[i]*xm*xm2) + (b[i]*xm2) + (yplow[i]*xm) + Y(i);
+	Real f = ((*a)[i]*xm*xm2) + ((*b)[i]*xm2) + ((*yplow)[i]*xm) + Y(i);
 
   
   return f;
@@ -8,6 +8,7 @@
   */
 
 #include "InterpolatorBase.hpp"
+#include "libInterpolate/Utils/LruCache.hpp"
 
 /** @class 
   * @brief Cubic spline interpolation for for 2D functions.
@@ -16,6 +17,10 @@
   * This class implements the bicubic spline interpolation method.
   * It is essentially the 2D equivalent of cubic splines for 1D. 
   *
+  * By default the coefficients of every patch are computed when the data is set.
+  * For large grids, setLazyPatchCache() makes them computed on first use instead,
+  * keeping only the most recently used patches.
+  *
   */
 
 namespace _2D {
@@ -47,7 +52,12 @@ class BicubicInterpolator : public InterpolatorBase<BicubicInterpolator<Real>>
     using BASE::Y;
     using BASE::Z;
     
-    Matrix44Array a; // naming convention used by wikipedia article (see Wikipedia https://en.wikipedia.org/wiki/Bicubic_interpolation)
+    using PatchCache = libInterpolate::Utils::LruCache<long, Matrix44>;
+
+    // the coefficients are shared between copies, setupInterpolator() replaces them instead of modifying them
+    std::shared_ptr<const Matrix44Array> a; // naming convention used by wikipedia article (see Wikipedia https://en.wikipedia.org/wiki/Bicubic_interpolation)
+    std::shared_ptr<PatchCache> lazyPatches; // used instead of a in lazy mode
+    size_t lazyPatchCapacity = 0;
 
   public:
 
@@ -63,12 +73,16 @@ class BicubicInterpolator : public InterpolatorBase<BicubicInterpolator<Real>>
     BicubicInterpolator(const BicubicInterpolator& rhs)
     :BASE(rhs)
     ,a(rhs.a)
+    ,lazyPatches(rhs.lazyPatches)
+    ,lazyPatchCapacity(rhs.lazyPatchCapacity)
     {}
 
     // copy-swap idiom
     friend void swap( BicubicInterpolator& lhs, BicubicInterpolator& rhs)
     {
-      lhs.a.swap(rhs.a);
+      std::swap( lhs.a, rhs.a );
+      std::swap( lhs.lazyPatches, rhs.lazyPatches );
+      std::swap( lhs.lazyPatchCapacity, rhs.lazyPatchCapacity );
       swap( static_cast<BASE&>(lhs), static_cast<BASE&>(rhs) );
     }
 
@@ -82,9 +96,19 @@ class BicubicInterpolator : public InterpolatorBase<BicubicInterpolator<Real>>
     // methods required by the interface
     Real operator()( Real x, Real y ) const;
 
+    /**
+     * Computes the patch coefficients on first use and caches at most maxPatches of them,
+     * instead of computing all of them when the data is set. 0 (the default) computes them
+     * all up front. Takes effect with the next call to setData().
+     */
+    void setLazyPatchCache( size_t maxPatches ) { lazyPatchCapacity = maxPatches; }
+    size_t getLazyPatchCache() const { return lazyPatchCapacity; }
+
   protected:
 
     void setupInterpolator();
+    Matrix44 computePatchCoefficients( int i, int j ) const;
+    Real evaluate_in_cell( Real x, Real y, int i, int j ) const;
     friend BASE;
 
 };
@@ -95,10 +119,34 @@ BicubicInterpolator<Real>::setupInterpolator()
 {
   // Interpolation will be done by multiplying the coordinates by coefficients.
 
-  a = Matrix44Array( X->size()-1, Y->size()-1 );
+  // in lazy mode the patches are computed by evaluate_in_cell as they are needed.
+  // copies may still be using the cache of the previous data, so a new one is started.
+  if( lazyPatchCapacity > 0 )
+  {
+    a.reset();
+    lazyPatches = std::make_shared<PatchCache>(lazyPatchCapacity);
+    return;
+  }
+
+  lazyPatches.reset();
+  auto coefficients = std::make_shared<Matrix44Array>( X->size()-1, Y->size()-1 );
 
   // We are going to precompute the interpolation coefficients so
   // that we can interpolate quickly. This requires a 4x4 matrix for each "patch".
+  for(int i = 0; i < X->size() - 1; i++)
+  {
+    for( int j = 0; j < Y->size() - 1; j++)
+    {
+      (*coefficients)(i,j) = computePatchCoefficients(i, j);
+    }
+  }
+  a = std::move(coefficients);
+}
+
+template<class Real>
+typename BicubicInterpolator<Real>::Matrix44
+BicubicInterpolator<Real>::computePatchCoefficients( int i, int j ) const
+{
   Matrix44 Left, Right;
 
   Left <<  1,  0,  0,  0,
@@ -111,167 +159,161 @@ BicubicInterpolator<Real>::setupInterpolator()
            0,  1, -2,  1,
            0,  0, -1,  1;
 
-  for(int i = 0; i < X->size() - 1; i++)
-  {
-    for( int j = 0; j < Y->size() - 1; j++)
-    {
-      Matrix44 F;
-
-      Real f00,   f01,   f10,   f11;
-      Real fx00,  fx01,  fx10,  fx11;
-      Real fy00,  fy01,  fy10,  fy11;
-      Real fxy00, fxy01, fxy10, fxy11;
-
-      Real fm, fp;
-      int im, ip, jm, jp;
-
-      int iN = X->size();
-      int jN = Y->size();
-
-      // function values
-      f00 = (*Z)(i    ,j    ); // <<<<<<
-      f01 = (*Z)(i    ,j + 1); // <<<<<<
-      f10 = (*Z)(i + 1,j    ); // <<<<<<
-      f11 = (*Z)(i + 1,j + 1); // <<<<<<
-
-      // need to calculate function values and derivatives
-      // at each corner.
-      //
-      // note: interpolation algorithm is derived for the unit square.
-      // so we need to take the derivatives assuming X(i+1) - X(i) = Y(j+1) - Y(j) = 1
-      //
-      // using finite-difference approximation. central-difference on the interior,
-      // forwared and backward difference on the ends.
-      
-      Real xL = (*X)(i+1) - (*X)(i); // actual side length in x direction
-      Real yL = (*Y)(j+1) - (*Y)(j); // actual side length in y direction
-      Real dx, dy;
-
-      // x derivatives
-      //  
-      //   (i,j+1)     (i+1,j+1)
-      //
-      //   +        +
-      // 
-      // 
-      //   +        +
-      // 
-      //  (i,j)     (i+1,j)
+  Matrix44 F;
+
+  Real f00,   f01,   f10,   f11;
+  Real fx00,  fx01,  fx10,  fx11;
+  Real fy00,  fy01,  fy10,  fy11;
+  Real fxy00, fxy01, fxy10, fxy11;
+
+  Real fm, fp;
+  int im, ip, jm, jp;
+
+  int iN = static_cast<int>(X->size());
+  int jN = static_cast<int>(Y->size());
+
+  // function values
+  f00 = (*Z)(i    ,j    ); // <<<<<<
+  f01 = (*Z)(i    ,j + 1); // <<<<<<
+  f10 = (*Z)(i + 1,j    ); // <<<<<<
+  f11 = (*Z)(i + 1,j + 1); // <<<<<<
+
+  // need to calculate function values and derivatives
+  // at each corner.
+  //
+  // note: interpolation algorithm is derived for the unit square.
+  // so we need to take the derivatives assuming X(i+1) - X(i) = Y(j+1) - Y(j) = 1
+  //
+  // using finite-difference approximation. central-difference on the interior,
+  // forwared and backward difference on the ends.
   
-      im = std::max(i-1,0);    // get index to the "left" of current i
-      ip = std::min(i+1,iN-1); // get index to the "right" of current i
+  Real xL = (*X)(i+1) - (*X)(i); // actual side length in x direction
+  Real yL = (*Y)(j+1) - (*Y)(j); // actual side length in y direction
+  Real dx, dy;
+
+  // x derivatives
+  //  
+  //   (i,j+1)     (i+1,j+1)
+  //
+  //   +        +
+  // 
+  // 
+  //   +        +
+  // 
+  //  (i,j)     (i+1,j)
+  
+  im = std::max(i-1,0);    // get index to the "left" of current i
+  ip = std::min(i+1,iN-1); // get index to the "right" of current i
 
-      dx = ((*X)(ip) - (*X)(im))/xL; // relative distance between "right" and "left" neighbors
+  dx = ((*X)(ip) - (*X)(im))/xL; // relative distance between "right" and "left" neighbors
 
-      fp = (*Z)(ip,j);
-      fm = (*Z)(im,j);
-      fx00 = (fp - fm) / dx; // <<<<<<
+  fp = (*Z)(ip,j);
+  fm = (*Z)(im,j);
+  fx00 = (fp - fm) / dx; // <<<<<<
 
-      fp = (*Z)(ip,j+1);
-      fm = (*Z)(im,j+1);
-      fx01 = (fp - fm) / dx; // <<<<<<
+  fp = (*Z)(ip,j+1);
+  fm = (*Z)(im,j+1);
+  fx01 = (fp - fm) / dx; // <<<<<<
 
 
-      im = std::max(i,0);
-      ip = std::min(i+2,iN-1);
+  im = std::max(i,0);
+  ip = std::min(i+2,iN-1);
 
-      dx = ((*X)(ip) - (*X)(im))/xL;
+  dx = ((*X)(ip) - (*X)(im))/xL;
 
-      fp = (*Z)(ip,j);
-      fm = (*Z)(im,j);
-      fx10 = (fp - fm) / dx; // <<<<<<
+  fp = (*Z)(ip,j);
+  fm = (*Z)(im,j);
+  fx10 = (fp - fm) / dx; // <<<<<<
 
-      fp = (*Z)(ip,j+1);
-      fm = (*Z)(im,j+1);
-      fx11 = (fp - fm) / dx; // <<<<<<
+  fp = (*Z)(ip,j+1);
+  fm = (*Z)(im,j+1);
+  fx11 = (fp - fm) / dx; // <<<<<<
 
 
-      // y derivatives
+  // y derivatives
 
-      jm = std::max(j-1,0);
-      jp = std::min(j+1,jN-1);
+  jm = std::max(j-1,0);
+  jp = std::min(j+1,jN-1);
 
-      dy = ((*Y)(jp) - (*Y)(jm))/yL;
+  dy = ((*Y)(jp) - (*Y)(jm))/yL;
 
-      fp = (*Z)(i,jp);
-      fm = (*Z)(i,jm);
-      fy00 = (fp - fm) / dy; // <<<<<<
+  fp = (*Z)(i,jp);
+  fm = (*Z)(i,jm);
+  fy00 = (fp - fm) / dy; // <<<<<<
 
-      fp = (*Z)(i+1,jp);
-      fm = (*Z)(i+1,jm);
-      fy10 = (fp - fm) / dy; // <<<<<<
+  fp = (*Z)(i+1,jp);
+  fm = (*Z)(i+1,jm);
+  fy10 = (fp - fm) / dy; // <<<<<<
 
 
-      jm = std::max(j,0);
-      jp = std::min(j+2,jN-1);
+  jm = std::max(j,0);
+  jp = std::min(j+2,jN-1);
 
-      dy = ((*Y)(jp) - (*Y)(jm))/yL;
+  dy = ((*Y)(jp) - (*Y)(jm))/yL;
 
-      fp = (*Z)(i,jp);
-      fm = (*Z)(i,jm);
-      fy01 = (fp - fm) / dx; // <<<<<<
+  fp = (*Z)(i,jp);
+  fm = (*Z)(i,jm);
+  fy01 = (fp - fm) / dx; // <<<<<<
 
-      fp = (*Z)(i+1,jp);
-      fm = (*Z)(i+1,jm);
-      fy11 = (fp - fm) / dx; // <<<<<<
+  fp = (*Z)(i+1,jp);
+  fm = (*Z)(i+1,jm);
+  fy11 = (fp - fm) / dx; // <<<<<<
 
-      // xy derivatives
+  // xy derivatives
 
-      im = std::max(i-1,0);
-      ip = std::min(i+1,iN-1);
-      jm = std::max(j-1,0);
-      jp = std::min(j+1,jN-1);
+  im = std::max(i-1,0);
+  ip = std::min(i+1,iN-1);
+  jm = std::max(j-1,0);
+  jp = std::min(j+1,jN-1);
 
-      dx = ((*X)(ip) - (*X)(im)) / xL;
+  dx = ((*X)(ip) - (*X)(im)) / xL;
 
-      dy = ((*Y)(jp) - (*Y)(jm)) / yL;
+  dy = ((*Y)(jp) - (*Y)(jm)) / yL;
 
-      fp = ((*Z)(ip,jp) - (*Z)(im,jp))/dx;
-      fm = ((*Z)(ip,jm) - (*Z)(im,jm))/dx;
-      fxy00 = (fp - fm) / dy; // <<<<<<
+  fp = ((*Z)(ip,jp) - (*Z)(im,jp))/dx;
+  fm = ((*Z)(ip,jm) - (*Z)(im,jm))/dx;
+  fxy00 = (fp - fm) / dy; // <<<<<<
 
 
-      jm = std::max(j,0);
-      jp = std::min(j+2,jN-1);
+  jm = std::max(j,0);
+  jp = std::min(j+2,jN-1);
 
-      dy = ((*Y)(jp) - (*Y)(jm))/yL;
+  dy = ((*Y)(jp) - (*Y)(jm))/yL;
 
-      fp = ((*Z)(ip,jp) - (*Z)(im,jp))/dx;
-      fm = ((*Z)(ip,jm) - (*Z)(im,jm))/dx;
-      fxy01 = (fp - fm) / dy; // <<<<<<
+  fp = ((*Z)(ip,jp) - (*Z)(im,jp))/dx;
+  fm = ((*Z)(ip,jm) - (*Z)(im,jm))/dx;
+  fxy01 = (fp - fm) / dy; // <<<<<<
 
 
-      im = std::max(i,0);
-      ip = std::min(i+2,iN-1);
-      jm = std::max(j-1,0);
-      jp = std::min(j+1,jN-1);
+  im = std::max(i,0);
+  ip = std::min(i+2,iN-1);
+  jm = std::max(j-1,0);
+  jp = std::min(j+1,jN-1);
 
-      dx = ((*X)(ip) - (*X)(im)) / xL;
+  dx = ((*X)(ip) - (*X)(im)) / xL;
 
-      dy = ((*Y)(jp) - (*Y)(jm)) / yL;
+  dy = ((*Y)(jp) - (*Y)(jm)) / yL;
 
-      fp = ((*Z)(ip,jp) - (*Z)(im,jp))/dx;
-      fm = ((*Z)(ip,jm) - (*Z)(im,jm))/dx;
-      fxy10 = (fp - fm) / dy; // <<<<<<
+  fp = ((*Z)(ip,jp) - (*Z)(im,jp))/dx;
+  fm = ((*Z)(ip,jm) - (*Z)(im,jm))/dx;
+  fxy10 = (fp - fm) / dy; // <<<<<<
 
-      jm = std::max(j,0);
-      jp = std::min(j+2,jN-1);
+  jm = std::max(j,0);
+  jp = std::min(j+2,jN-1);
 
-      dy = ((*Y)(jp) - (*Y)(jm)) / yL;
+  dy = ((*Y)(jp) - (*Y)(jm)) / yL;
 
-      fp = ((*Z)(ip,jp) - (*Z)(im,jp))/dx;
-      fm = ((*Z)(ip,jm) - (*Z)(im,jm))/dx;
-      fxy11 = (fp - fm) / dy; // <<<<<<
+  fp = ((*Z)(ip,jp) - (*Z)(im,jp))/dx;
+  fm = ((*Z)(ip,jm) - (*Z)(im,jm))/dx;
+  fxy11 = (fp - fm) / dy; // <<<<<<
 
 
-      F <<  f00,  f01,  fy00,  fy01,
-            f10,  f11,  fy10,  fy11,
-           fx00, fx01, fxy00, fxy01,
-           fx10, fx11, fxy10, fxy11;
+  F <<  f00,  f01,  fy00,  fy01,
+        f10,  f11,  fy10,  fy11,
+       fx00, fx01, fxy00, fxy01,
+       fx10, fx11, fxy10, fxy11;
 
-      a(i,j) = Left * F * Right;
-    }
-  }
+  return Left * F * Right;
 }
 
 template<class Real>
@@ -297,8 +339,14 @@ BicubicInterpolator<Real>::operator()( Real x, Real y ) const
     i = 0;
   if(j < 0)
     j = 0;
-  
 
+  return evaluate_in_cell(x, y, i, j);
+}
+
+template<class Real>
+Real
+BicubicInterpolator<Real>::evaluate_in_cell( Real x, Real y, int i, int j ) const
+{
   Real xL = (*X)(i+1) - (*X)(i);
   Real yL = (*Y)(j+1) - (*Y)(j);
 
@@ -318,7 +366,13 @@ BicubicInterpolator<Real>::operator()( Real x, Real y ) const
 
   // interpolation is just x*a*y
 
-  return vx*a(i,j)*vy;
+  if( lazyPatches )
+  {
+    const long key = static_cast<long>(i) * (Y->size() - 1) + j;
+    return vx*lazyPatches->get(key, [&]() { return computePatchCoefficients(i, j); })*vy;
+  }
+
+  return vx*(*a)(i,j)*vy;
 
 }
 
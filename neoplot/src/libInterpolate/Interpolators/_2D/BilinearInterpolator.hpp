@@ -46,7 +46,8 @@ class BilinearInterpolator : public InterpolatorBase<BilinearInterpolator<Real>>
     using BASE::Y;
     using BASE::Z;
     
-    Matrix22Array Q; // naming convention used by wikipedia article (see Wikipedia https://en.wikipedia.org/wiki/Bilinear_interpolation)
+    // the coefficients are shared between copies, setupInterpolator() replaces them instead of modifying them
+    std::shared_ptr<const Matrix22Array> Q; // naming convention used by wikipedia article (see Wikipedia https://en.wikipedia.org/wiki/Bilinear_interpolation)
 
 
   public:
@@ -66,7 +67,7 @@ class BilinearInterpolator : public InterpolatorBase<BilinearInterpolator<Real>>
     // copy-swap idiom
     friend void swap( BilinearInterpolator& lhs, BilinearInterpolator& rhs)
     {
-      lhs.Q.swap(rhs.Q);
+      std::swap( lhs.Q, rhs.Q );
       swap( static_cast<BASE&>(lhs), static_cast<BASE&>(rhs) );
     }
 
@@ -82,6 +83,7 @@ class BilinearInterpolator : public InterpolatorBase<BilinearInterpolator<Real>>
   private:
 
     void setupInterpolator();
+    Real evaluate_in_cell( Real x, Real y, int i, int j ) const;
     friend BASE;
 
 };
@@ -93,7 +95,7 @@ BilinearInterpolator<Real>::setupInterpolator()
 
   // Interpolation will be done by multiplying the coordinates by coefficients.
 
-  Q = Matrix22Array( X->size()-1, Y->size()-1 );
+  auto coefficients = std::make_shared<Matrix22Array>( X->size()-1, Y->size()-1 );
 
   // We are going to pre-compute the interpolation coefficients so
   // that we can interpolate quickly
@@ -102,9 +104,10 @@ BilinearInterpolator<Real>::setupInterpolator()
     for( int j = 0; j < Y->size() - 1; j++)
     {
       Real tmp = ( ((*X)(i+1) - (*X)(i) )*( (*Y)(j+1) - (*Y)(j) ) );
-      Q(i,j) = Z->block(i,j,2,2)/tmp;
+      (*coefficients)(i,j) = Z->block(i,j,2,2)/tmp;
     }
   }
+  Q = std::move(coefficients);
 }
 
 template<class Real>
@@ -129,9 +132,14 @@ BilinearInterpolator<Real>::operator()( Real x, Real y ) const
     i = 0;
   if(j < 0)
     j = 0;
-  
 
+  return evaluate_in_cell(x, y, i, j);
+}
 
+template<class Real>
+Real
+BilinearInterpolator<Real>::evaluate_in_cell( Real x, Real y, int i, int j ) const
+{
   // now, create the coordinate vectors (see Wikipedia https://en.wikipedia.org/wiki/Bilinear_interpolation)
   RowVector2 vx;
   ColVector2 vy;
@@ -140,7 +148,7 @@ BilinearInterpolator<Real>::operator()( Real x, Real y ) const
 
   // interpolation is just x*Q*y
 
-  return vx*Q(i,j)*vy;
+  return vx*(*Q)(i,j)*vy;
 }
 
 
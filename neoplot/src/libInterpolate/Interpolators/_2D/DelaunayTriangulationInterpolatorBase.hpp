@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <array>
+#include <memory>
 
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/ring.hpp>
@@ -30,28 +31,84 @@ class DelaunayTriangulationInterpolatorBase : public InterpolatorBase<DelaunayTr
   using box_t = boost::geometry::model::box<point_t>;
   using rtree_value_t = std::pair<box_t,size_t>;
 
-  std::vector<triangle_t> getTriangles() const { return m_xy_triangles; }
+  static constexpr size_t no_triangle = delaunator::INVALID_INDEX;
+
+  std::vector<triangle_t> getTriangles() const { return m_xy_triangles ? *m_xy_triangles : std::vector<triangle_t>(); }
+
+  /**
+   * Interpolates at the points (xs[i], ys[i]). Consecutive points are located by walking from the
+   * triangle of the previous point to its neighbours, so spatially coherent queries, like the pixels
+   * of a raster in scanline order, avoid most of the R-tree searches.
+   */
+  template<typename XIter, typename YIter, typename ZIter>
+  void batch(XIter x_begin, XIter x_end, YIter y_begin, ZIter z_begin) const
+  {
+    size_t hint = no_triangle;
+    const std::ptrdiff_t N = std::distance(x_begin, x_end);
+    for(std::ptrdiff_t i = 0; i < N; ++i) {
+      point_t p{static_cast<Real>(*(x_begin + i)), static_cast<Real>(*(y_begin + i))};
+      size_t t = hint == no_triangle ? no_triangle : walk_to_triangle(p, hint);
+      if(t == no_triangle)
+        t = find_triangle(p);
+
+      if(t == no_triangle) {
+        // do not extrapolate
+        *(z_begin + i) = 0;
+      } else {
+        *(z_begin + i) = static_cast<const Derived *>(this)->evaluate_in_triangle(p[0], p[1], t);
+        hint = t;
+      }
+    }
+  }
+
+  std::vector<Real> batch(const std::vector<Real> &xs, const std::vector<Real> &ys) const
+  {
+    std::vector<Real> zs(xs.size());
+    this->batch(xs.begin(), xs.end(), ys.begin(), zs.begin());
+    return zs;
+  }
 
  private:
   friend BASE;     // this is necessary to allow base class to call setupInterpolator()
   friend Derived;  // this is necessary to allow derived class to call constructors
 
-  std::vector<triangle_t> m_xy_triangles;
-  std::vector<std::array<size_t,3>> m_triangle_datapoints;
-  boost::geometry::index::rtree<rtree_value_t,boost::geometry::index::quadratic<16> > m_triangles_index;
+  // a triangle walk that has not arrived after this many steps falls back to the R-tree
+  static constexpr int max_walk_steps = 64;
+
+  using rtree_t = boost::geometry::index::rtree<rtree_value_t,boost::geometry::index::quadratic<16> >;
+
+  // the triangulation is immutable once it is built and shared between copies
+  std::shared_ptr<const std::vector<triangle_t>> m_xy_triangles;
+  std::shared_ptr<const std::vector<std::array<size_t,3>>> m_triangle_datapoints;
+  // m_triangle_neighbours[t][k] shares the edge from vertex k to vertex k+1 of triangle t
+  std::shared_ptr<const std::vector<std::array<size_t,3>>> m_triangle_neighbours;
+  std::shared_ptr<const rtree_t> m_triangles_index;
 
 
   void setupInterpolator()
   {
+    const auto &x = *this->xView;
+    const auto &y = *this->yView;
     std::vector<Real> coords;
-    coords.reserve(2 * this->xData.size());
-    for(size_t i = 0; i < this->xData.size(); ++i) {
-      coords.push_back(this->xData[i]);
-      coords.push_back(this->yData[i]);
+    coords.reserve(2 * static_cast<size_t>(x.size()));
+    for(Eigen::Index i = 0; i < x.size(); ++i) {
+      coords.push_back(x(i));
+      coords.push_back(y(i));
     }
 
     delaunator::Delaunator<Real> triangulation(coords);
 
+    const size_t num_triangles = triangulation.triangles.size() / 3;
+    auto xy_triangles = std::make_shared<std::vector<triangle_t>>();
+    auto triangle_datapoints = std::make_shared<std::vector<std::array<size_t,3>>>();
+    auto triangle_neighbours = std::make_shared<std::vector<std::array<size_t,3>>>();
+    xy_triangles->reserve(num_triangles);
+    triangle_datapoints->reserve(num_triangles);
+    triangle_neighbours->reserve(num_triangles);
+
+    std::vector<rtree_value_t> boxes;
+    boxes.reserve(num_triangles);
+
     for(size_t i = 0; i < triangulation.triangles.size(); i += 3) {
       point_t p1 = {triangulation.coords[2 * triangulation.triangles[i]], triangulation.coords[2 * triangulation.triangles[i] + 1]};
       point_t p2 = {triangulation.coords[2 * triangulation.triangles[i + 1]], triangulation.coords[2 * triangulation.triangles[i + 1] + 1]};
@@ -59,16 +116,84 @@ class DelaunayTriangulationInterpolatorBase : public InterpolatorBase<DelaunayTr
 
       triangle_t t{p1, p2, p3, p1};
 
-      m_xy_triangles.push_back(t);
-      m_triangle_datapoints.push_back( {triangulation.triangles[i], triangulation.triangles[i+1], triangulation.triangles[i+2]} );
+      xy_triangles->push_back(t);
+      triangle_datapoints->push_back( {triangulation.triangles[i], triangulation.triangles[i+1], triangulation.triangles[i+2]} );
+
+      std::array<size_t,3> neighbours;
+      for(size_t k = 0; k < 3; ++k) {
+        const size_t opposite = triangulation.halfedges[i + k];
+        neighbours[k] = opposite == delaunator::INVALID_INDEX ? no_triangle : opposite / 3;
+      }
+      triangle_neighbours->push_back(neighbours);
 
-      box_t b = boost::geometry::return_envelope<box_t>(t);
-      m_triangles_index.insert( std::make_pair(b, m_xy_triangles.size()-1 ) );
+      boxes.push_back( std::make_pair(boost::geometry::return_envelope<box_t>(t), xy_triangles->size()-1 ) );
     }
 
+    // bulk loading builds a better tree much faster than inserting one box at a time
+    m_triangles_index = std::make_shared<const rtree_t>(boxes.begin(), boxes.end());
+    m_xy_triangles = std::move(xy_triangles);
+    m_triangle_datapoints = std::move(triangle_datapoints);
+    m_triangle_neighbours = std::move(triangle_neighbours);
 
     this->template callSetupInterpolator<Derived>();
 
   }
+
+  static Real orientation(const point_t &a, const point_t &b, const point_t &p)
+  {
+    return (b[0] - a[0]) * (p[1] - a[1]) - (b[1] - a[1]) * (p[0] - a[0]);
+  }
+
+  /**
+   * Returns true if p lies inside of triangle t or on its boundary.
+   */
+  bool triangle_covers(size_t t, const point_t &p) const
+  {
+    const auto &v = (*m_xy_triangles)[t];
+    const Real d0 = orientation(v[0], v[1], p);
+    const Real d1 = orientation(v[1], v[2], p);
+    const Real d2 = orientation(v[2], v[0], p);
+    return (d0 >= 0 && d1 >= 0 && d2 >= 0) || (d0 <= 0 && d1 <= 0 && d2 <= 0);
+  }
+
+  /**
+   * Locates p through the R-tree, returns no_triangle outside of the triangulation.
+   */
+  size_t find_triangle(const point_t &p) const
+  {
+    if(!m_triangles_index)
+      return no_triangle;
+
+    for(auto it = m_triangles_index->qbegin(boost::geometry::index::covers(p)); it != m_triangles_index->qend(); ++it) {
+      if(triangle_covers(it->second, p))
+        return it->second;
+    }
+    return no_triangle;
+  }
+
+  /**
+   * Walks from triangle start towards p, crossing an edge that separates the current triangle
+   * from p in every step. Returns no_triangle if the walk leaves the triangulation or takes too long.
+   */
+  size_t walk_to_triangle(const point_t &p, size_t start) const
+  {
+    size_t t = start;
+    for(int step = 0; step < max_walk_steps; ++step) {
+      const auto &v = (*m_xy_triangles)[t];
+      // the sign of the orientation of the triangle itself, p is inside if no edge disagrees
+      const Real sign = orientation(v[0], v[1], v[2]) > 0 ? 1 : -1;
+      size_t next = t;
+      for(size_t k = 0; k < 3; ++k) {
+        if(sign * orientation(v[k], v[k + 1], p) < 0) {
+          next = (*m_triangle_neighbours)[t][k];
+          break;
+        }
+      }
+      if(next == t || next == no_triangle)
+        return next;
+      t = next;
+    }
+    return no_triangle;
+  }
 };
 }  // namespace _2D
@@ -6,8 +6,11 @@
   * @date 12/24/16
   */
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <boost/range/adaptor/strided.hpp>
@@ -38,6 +41,10 @@ struct RealTypeOf<T<B,R>> {
   *
   * This class provides an implementation for the setData method as well as adding a few additional
   * useful methods, including derivative and integral methods.
+  *
+  * The data is immutable once it is set and shared between copies of an interpolator, so copying
+  * a configured interpolator does not duplicate the data. Setting new data replaces it in this
+  * interpolator only.
   */
 template<class Derived, typename Real = typename RealTypeOf<Derived>::type>
 class InterpolatorBase
@@ -51,7 +58,7 @@ class InterpolatorBase
   using _2DMatrixView = Eigen::Map<const MatrixType, Eigen::Unaligned, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
 
  private:
-  std::vector<Real> xData, yData, zData;  // data storage
+  std::shared_ptr<const std::vector<Real>> xData, yData, zData;  // data storage, shared with copies
 
  protected:
   std::unique_ptr<MapType> xView, yView, zView;  // map view of the data
@@ -69,9 +76,8 @@ class InterpolatorBase
   InterpolatorBase() = default;
 
   InterpolatorBase(const InterpolatorBase &rhs)
-      : xData(rhs.xData), yData(rhs.yData), zData(rhs.zData), xView(rhs.xView ? new MapType(xData.data(), xData.size()) : nullptr), yView(rhs.xView ? new MapType(yData.data(), yData.size()) : nullptr), zView(rhs.zView ? new MapType(zData.data(), zData.size()) : nullptr)
+      : xData(rhs.xData), yData(rhs.yData), zData(rhs.zData), xView(rhs.xView ? new MapType(*rhs.xView) : nullptr), yView(rhs.yView ? new MapType(*rhs.yView) : nullptr), zView(rhs.zView ? new MapType(*rhs.zView) : nullptr), X(rhs.X ? new _2DVectorView(*rhs.X) : nullptr), Y(rhs.Y ? new _2DVectorView(*rhs.Y) : nullptr), Z(rhs.Z ? new _2DMatrixView(*rhs.Z) : nullptr)
   {
-    this->setup2DDataViews();
   }
 
   // we use the copy-swap idiom for copy assignment
@@ -95,12 +101,12 @@ class InterpolatorBase
   }
 
  public:
-  const std::vector<Real> &getXData() const { return xData; }
-  const std::vector<Real> &getYData() const { return yData; }
-  const std::vector<Real> &getZData() const { return zData; }
-  std::vector<Real>        getXData() { return xData; }
-  std::vector<Real>        getYData() { return yData; }
-  std::vector<Real>        getZData() { return zData; }
+  const std::vector<Real> &getXData() const { return xData ? *xData : noData(); }
+  const std::vector<Real> &getYData() const { return yData ? *yData : noData(); }
+  const std::vector<Real> &getZData() const { return zData ? *zData : noData(); }
+  std::vector<Real>        getXData() { return std::as_const(*this).getXData(); }
+  std::vector<Real>        getYData() { return std::as_const(*this).getYData(); }
+  std::vector<Real>        getZData() { return std::as_const(*this).getZData(); }
 
   /**
      * Set references to the interpolated data to memory outside the interpolator.
@@ -130,32 +136,58 @@ class InterpolatorBase
   template<typename XIter, typename YIter, typename ZIter>
   auto
   setData(const XIter &x_begin, const XIter &x_end, const YIter &y_begin, const YIter &y_end, const ZIter &z_begin, const ZIter &z_end)
-      -> decltype(std::copy(x_begin, x_end, xData.begin()), std::copy(y_begin, y_end, yData.begin()), std::copy(z_begin, z_end, zData.begin()), void())
+      -> decltype(std::copy(x_begin, x_end, std::declval<std::vector<Real> &>().begin()), std::copy(y_begin, y_end, std::declval<std::vector<Real> &>().begin()), std::copy(z_begin, z_end, std::declval<std::vector<Real> &>().begin()), void())
   {
-    xData.clear();
-    yData.clear();
-    zData.clear();
+    auto x = std::make_shared<std::vector<Real>>();
+    auto y = std::make_shared<std::vector<Real>>();
+    auto z = std::make_shared<std::vector<Real>>();
 
-    xData.reserve(z_end - z_begin);
-    yData.reserve(z_end - z_begin);
-    zData.reserve(z_end - z_begin);
+    x->reserve(z_end - z_begin);
+    y->reserve(z_end - z_begin);
+    z->reserve(z_end - z_begin);
 
     if((x_end - x_begin) == (z_end - z_begin) && (y_end - y_begin) == (z_end - z_begin)) {
-      std::copy(x_begin, x_end, std::back_inserter(xData));
-      std::copy(y_begin, y_end, std::back_inserter(yData));
-      std::copy(z_begin, z_end, std::back_inserter(zData));
+      std::copy(x_begin, x_end, std::back_inserter(*x));
+      std::copy(y_begin, y_end, std::back_inserter(*y));
+      std::copy(z_begin, z_end, std::back_inserter(*z));
     } else if((x_end - x_begin) * (y_end - y_begin) == (z_end - z_begin)) {
-      std::copy(z_begin, z_end, std::back_inserter(zData));
+      std::copy(z_begin, z_end, std::back_inserter(*z));
       for(auto it = x_begin; it != x_end; it++) {
-        std::fill_n(std::back_inserter(xData), y_end - y_begin, *it);
-        std::copy(y_begin, y_end, std::back_inserter(yData));
+        std::fill_n(std::back_inserter(*x), y_end - y_begin, *it);
+        std::copy(y_begin, y_end, std::back_inserter(*y));
       }
 
     } else {
       throw std::runtime_error("Interpolator data format is not supported. The x, y, and z data containers should all be the same length, or the length of the z container should be equal to the product of the length of the x and y containers.");
     }
 
-    this->setUnsafeDataReference(xData.size(), xData.data(), yData.data(), zData.data());
+    this->setSharedData(std::move(x), std::move(y), std::move(z));
+  }
+
+  /**
+   * Set the data that will be interpolated by moving it into the interpolator. Only z is moved if x
+   * and y are the coordinates of a grid, they still have to be expanded to one value per point.
+   */
+  void
+  setData(std::vector<Real> &&x, std::vector<Real> &&y, std::vector<Real> &&z)
+  {
+    if(x.size() == z.size() && y.size() == z.size()) {
+      this->setSharedData(std::make_shared<const std::vector<Real>>(std::move(x)),
+                          std::make_shared<const std::vector<Real>>(std::move(y)),
+                          std::make_shared<const std::vector<Real>>(std::move(z)));
+    } else if(x.size() * y.size() == z.size()) {
+      auto xs = std::make_shared<std::vector<Real>>();
+      auto ys = std::make_shared<std::vector<Real>>();
+      xs->reserve(z.size());
+      ys->reserve(z.size());
+      for(const Real xi : x) {
+        xs->insert(xs->end(), y.size(), xi);
+        ys->insert(ys->end(), y.begin(), y.end());
+      }
+      this->setSharedData(std::move(xs), std::move(ys), std::make_shared<const std::vector<Real>>(std::move(z)));
+    } else {
+      this->setData(x.begin(), x.end(), y.begin(), y.end(), z.begin(), z.end());
+    }
   }
 
   /**
@@ -226,10 +258,64 @@ class InterpolatorBase
     return this->get_y_index_below(y) + 1;
   }
 
+  /**
+   * Evaluates the interpolator on the grid spanned by xs and ys, for interpolators on gridded data
+   * that provide evaluate_in_cell(x, y, i, j). The cell of each x and each y is searched once instead
+   * of once per point. The result is written row by row, z[j*nx + i] = f(xs[i], ys[j]), points
+   * outside of the data are set to zero.
+   */
+  template<typename XIter, typename YIter, typename ZIter>
+  void batch_grid(XIter x_begin, XIter x_end, YIter y_begin, YIter y_end, ZIter z_begin) const
+  {
+    checkData();
+
+    const std::ptrdiff_t nx = std::distance(x_begin, x_end);
+    const std::ptrdiff_t ny = std::distance(y_begin, y_end);
+    const Real xmin = (*X)(0), xmax = (*X)(X->size() - 1);
+    const Real ymin = (*Y)(0), ymax = (*Y)(Y->size() - 1);
+    const int xlast = static_cast<int>(X->size()) - 2;
+    const int ylast = static_cast<int>(Y->size()) - 2;
+
+    // a cell index of -1 marks coordinates outside of the data
+    std::vector<int> xcells(static_cast<size_t>(nx)), ycells(static_cast<size_t>(ny));
+    for(size_t i = 0; i < xcells.size(); ++i) {
+      const Real x = *std::next(x_begin, static_cast<std::ptrdiff_t>(i));
+      xcells[i] = x < xmin || x > xmax ? -1 : std::clamp(get_x_index_to_left_of(x), 0, xlast);
+    }
+    for(size_t j = 0; j < ycells.size(); ++j) {
+      const Real y = *std::next(y_begin, static_cast<std::ptrdiff_t>(j));
+      ycells[j] = y < ymin || y > ymax ? -1 : std::clamp(get_y_index_below(y), 0, ylast);
+    }
+
+    auto z = z_begin;
+    for(size_t j = 0; j < ycells.size(); ++j) {
+      const Real y = *std::next(y_begin, static_cast<std::ptrdiff_t>(j));
+      auto x = x_begin;
+      for(size_t i = 0; i < xcells.size(); ++i, ++x, ++z) {
+        *z = xcells[i] < 0 || ycells[j] < 0 ? 0 : static_cast<const Derived *>(this)->evaluate_in_cell(*x, y, xcells[i], ycells[j]);
+      }
+    }
+  }
+
  protected:
   void checkData() const;   ///< Check that data has been initialized and throw exception if not.
   void setup2DDataViews();  ///< Setups up 2D views of 1D data arrays
 
+ private:
+  void setSharedData(std::shared_ptr<const std::vector<Real>> x, std::shared_ptr<const std::vector<Real>> y, std::shared_ptr<const std::vector<Real>> z)
+  {
+    xData = std::move(x);
+    yData = std::move(y);
+    zData = std::move(z);
+    this->setUnsafeDataReference(xData->size(), xData->data(), yData->data(), zData->data());
+  }
+
+  static const std::vector<Real> &noData()
+  {
+    static const std::vector<Real> empty;
+    return empty;
+  }
+
  protected:
   // callSetupInterpolator will call a function named setupInterpolator in the derived class, if
   // it exists. this is just some template magic to detect if the derived class has implemented a
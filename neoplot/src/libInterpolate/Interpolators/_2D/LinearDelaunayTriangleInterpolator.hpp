@@ -1,5 +1,8 @@
 #pragma once
 
+#include <memory>
+#include <utility>
+
 #include "DelaunayTriangulationInterpolatorBase.hpp"
 
 namespace _2D {
@@ -30,47 +33,13 @@ class LinearDelaunayTriangleInterpolator : public DelaunayTriangulationInterpola
 
     Real operator()( Real x, Real y) const
     {
-      point_t p{x,y};
-      // search optimization: find all boxes that envelope a triangle and cover the point first
-      std::vector<rtree_value_t> candidates;
-      this->m_triangles_index.query(boost::geometry::index::covers(p), std::back_inserter(candidates) );
-      for( auto& v: candidates)
-      {
-        size_t i = v.second;
-        auto &t = this->m_xy_triangles[i];
-        if( boost::geometry::covered_by(p,t) )
-        {
-          std::array<std::array<Real,3>,3> points;
-          size_t j = 0;
-          boost::geometry::for_each_point(t,[&i,&j,&points,this](const point_t& pp){
-              if( j > 2 )
-                return;
-              points[j][0] = pp[0];
-              points[j][1] = pp[1];
-              points[j][2] = this->getZData()[this->m_triangle_datapoints[i][j]];
-              j++;
-              });
-
-          boost::geometry::subtract_point(points[1],points[0]);
-          boost::geometry::subtract_point(points[2],points[0]);
-          auto surface_normal = boost::geometry::cross_product(points[2],points[1]);
-
-          // equation for a plane:
-          // (\vec{r} - \vec{r}_0) \cdot \vec{n} = 0 = \vec{r} \cdot \vec{n} - \vec{r}_0 \cdot \vec{n} = nx*(rx-r0x) + ny*(ry-r0y) + nz*(rz-r0z)
-          // nx*rx + ny*ry + nz*rz = \vec{n} \cdot \vec{r}_0
-          //
-          // we want to compute rz
-          //
-          // nz*rz = \vec{n} \cdot \vec{r}_0 - nx*rx - ny*ry
-          // rz = (\vec{n} \cdot \vec{r}_0 - nx*rx - ny*ry)/nz
-          Real z = (boost::geometry::dot_product( surface_normal, points[0] ) - p[0]*surface_normal[0] - p[1]*surface_normal[1])/surface_normal[2];
-
-          return z;
-        }
-      }
+      size_t i = this->find_triangle(point_t{x,y});
 
       // do not extrapolate
-      return 0;
+      if( i == BASE::no_triangle )
+        return 0;
+
+      return evaluate_in_triangle(x, y, i);
     }
 
   protected:
@@ -78,14 +47,51 @@ class LinearDelaunayTriangleInterpolator : public DelaunayTriangulationInterpola
 
   private:
     friend BASE;
+    friend typename BASE::BASE;  // detects and calls setupInterpolator()
+
+    // z = a*x + b*y + c over each triangle, shared between copies
+    std::shared_ptr<const std::vector<std::array<Real,3>>> m_planes;
+
     void setupInterpolator()
     {
+      const auto &z = *this->zView;
+      const auto &triangles = *m_xy_triangles;
+      auto planes = std::make_shared<std::vector<std::array<Real,3>>>(triangles.size());
+      for( size_t i = 0; i < triangles.size(); ++i)
+      {
+        auto &t = triangles[i];
+        std::array<std::array<Real,3>,3> points;
+        for( size_t j = 0; j < 3; ++j)
+        {
+          points[j][0] = t[j][0];
+          points[j][1] = t[j][1];
+          points[j][2] = z(static_cast<Eigen::Index>((*this->m_triangle_datapoints)[i][j]));
+        }
 
+        boost::geometry::subtract_point(points[1],points[0]);
+        boost::geometry::subtract_point(points[2],points[0]);
+        auto surface_normal = boost::geometry::cross_product(points[2],points[1]);
+
+        // equation for a plane:
+        // (\vec{r} - \vec{r}_0) \cdot \vec{n} = 0 = \vec{r} \cdot \vec{n} - \vec{r}_0 \cdot \vec{n} = nx*(rx-r0x) + ny*(ry-r0y) + nz*(rz-r0z)
+        // nx*rx + ny*ry + nz*rz = \vec{n} \cdot \vec{r}_0
+        //
+        // we want to compute rz
+        //
+        // nz*rz = \vec{n} \cdot \vec{r}_0 - nx*rx - ny*ry
+        // rz = (\vec{n} \cdot \vec{r}_0 - nx*rx - ny*ry)/nz
+        (*planes)[i] = { -surface_normal[0]/surface_normal[2],
+                         -surface_normal[1]/surface_normal[2],
+                         boost::geometry::dot_product( surface_normal, points[0] )/surface_normal[2] };
+      }
+      m_planes = std::move(planes);
     }
 
-
-
-
+    Real evaluate_in_triangle( Real x, Real y, size_t i ) const
+    {
+      const auto &plane = (*m_planes)[i];
+      return plane[0]*x + plane[1]*y + plane[2];
+    }
 
 };
 
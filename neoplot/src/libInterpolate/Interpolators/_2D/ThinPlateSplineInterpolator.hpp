@@ -7,7 +7,12 @@
   * @date 12/27/16
   */
 
+#include <cmath>
+#include <memory>
+#include <vector>
+
 #include "InterpolatorBase.hpp"
+#include "libInterpolate/Utils/Parallel.hpp"
 
 namespace _2D
 {
@@ -18,11 +23,13 @@ namespace _2D
   * This class implements the "Thin Plate Spline" method as derived by David Eberly (https://www.geometrictools.com/Documentation/ThinPlateSplines.pdf)
   * It is essentially the 2D equivalent of cubic splines for 1D. 
   *
-  * This method has a performance cost over other methods. Specifically, for N interpolation points, an NxN matrix
-  * must be inverted. The matrix inversion is only required during setup, but interpolation will be based on all
+  * This method has a performance cost over other methods. Specifically, for N interpolation points, an (N+3)x(N+3)
+  * system must be factorized. The factorization is only required during setup, but interpolation will be based on all
   * N points as well, rather than the nearest neighbors. So, it is possible that this method will be slow for
   * large data sets.
-  * 
+  *
+  * For large data sets, setLocalPatchSize() switches to an approximation that fits separate splines to overlapping
+  * patches of nearby points and blends between them.
   */
 
 template<class Real>
@@ -52,7 +59,27 @@ class ThinPlateSplineInterpolator : public InterpolatorBase<ThinPlateSplineInter
   using BASE::Z;
   using BASE::zView;
 
-  MatrixType a, b;
+  // the fitted coefficients are shared between copies, setupInterpolator() replaces them instead of modifying them
+  std::shared_ptr<const VectorType> a, b;
+
+  // a spline fitted to the points around one tile of the bounding box
+  struct Patch {
+    VectorType x, y;
+    VectorType a, b;
+  };
+
+  // queries are evaluated in blocks against tiles of centres, sized to stay on the stack and in cache
+  static constexpr int query_block = 16;
+  static constexpr int centre_tile = 256;
+  using QueryBlock = Eigen::Array<Real, Eigen::Dynamic, 1, 0, query_block, 1>;
+  using KernelTile = Eigen::Array<Real, Eigen::Dynamic, 1, 0, centre_tile, 1>;
+
+  int local_patch_size = 0;
+  Real x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  // patch of tile (i, j) is stored at i*num_tiles_y + j
+  int num_tiles_x = 0, num_tiles_y = 0;
+  Real tile_width = 1, tile_height = 1;
+  std::shared_ptr<const std::vector<Patch>> patches; // null unless fitted to local patches
 
  public:
   template<typename I>
@@ -72,15 +99,25 @@ class ThinPlateSplineInterpolator : public InterpolatorBase<ThinPlateSplineInter
   }
 
   ThinPlateSplineInterpolator(const ThinPlateSplineInterpolator &rhs)
-      : BASE(rhs), a(rhs.a), b(rhs.b)
+      : BASE(rhs), a(rhs.a), b(rhs.b), local_patch_size(rhs.local_patch_size), x_min(rhs.x_min), x_max(rhs.x_max), y_min(rhs.y_min), y_max(rhs.y_max), num_tiles_x(rhs.num_tiles_x), num_tiles_y(rhs.num_tiles_y), tile_width(rhs.tile_width), tile_height(rhs.tile_height), patches(rhs.patches)
   {
   }
 
   // copy-swap idiom
   friend void swap(ThinPlateSplineInterpolator &lhs, ThinPlateSplineInterpolator &rhs)
   {
-    lhs.a.swap(rhs.a);
-    lhs.b.swap(rhs.b);
+    std::swap(lhs.a, rhs.a);
+    std::swap(lhs.b, rhs.b);
+    std::swap(lhs.local_patch_size, rhs.local_patch_size);
+    std::swap(lhs.x_min, rhs.x_min);
+    std::swap(lhs.x_max, rhs.x_max);
+    std::swap(lhs.y_min, rhs.y_min);
+    std::swap(lhs.y_max, rhs.y_max);
+    std::swap(lhs.num_tiles_x, rhs.num_tiles_x);
+    std::swap(lhs.num_tiles_y, rhs.num_tiles_y);
+    std::swap(lhs.tile_width, rhs.tile_width);
+    std::swap(lhs.tile_height, rhs.tile_height);
+    std::swap(lhs.patches, rhs.patches);
     swap(static_cast<BASE &>(lhs), static_cast<BASE &>(rhs));
   }
 
@@ -92,9 +129,57 @@ class ThinPlateSplineInterpolator : public InterpolatorBase<ThinPlateSplineInter
 
   Real operator()(Real x, Real y) const;
 
+  /**
+   * Interpolates at the points (xs[i], ys[i]). Queries are split into blocks that are spread over all
+   * hardware threads, and the kernel of each block is computed against cache sized tiles of centres
+   * with vectorized array operations.
+   */
+  template<typename XIter, typename YIter, typename ZIter>
+  void batch(XIter x_begin, XIter x_end, YIter y_begin, ZIter z_begin) const
+  {
+    BASE::checkData();
+
+    const int N = static_cast<int>(std::distance(x_begin, x_end));
+    const int num_blocks = (N + query_block - 1) / query_block;
+    libInterpolate::Utils::parallel_for(0, num_blocks, [&](int block) {
+      const int begin = block * query_block;
+      const int n = std::min(query_block, N - begin);
+      QueryBlock qx(n), qy(n), z(n);
+      for(int k = 0; k < n; k++) {
+        qx(k) = *(x_begin + (begin + k));
+        qy(k) = *(y_begin + (begin + k));
+      }
+      evaluateBlock(qx, qy, z);
+      for(int k = 0; k < n; k++)
+        *(z_begin + (begin + k)) = z(k);
+    }, 4);
+  }
+
+  std::vector<Real> batch(const std::vector<Real> &xs, const std::vector<Real> &ys) const
+  {
+    std::vector<Real> zs(xs.size());
+    this->batch(xs.begin(), xs.end(), ys.begin(), zs.begin());
+    return zs;
+  }
+
+  /**
+   * Fit splines to local patches of about n points each instead of one spline to all points, 0 (the default)
+   * fits a single global spline. Setup then grows linearly with the number of points instead of cubically,
+   * at the cost of a small blending error. Takes effect with the next call to setData().
+   */
+  void setLocalPatchSize(int n) { local_patch_size = n; }
+  int getLocalPatchSize() const { return local_patch_size; }
+
  protected:
   Real G(Real x, Real y, Real xi, Real yi) const;
 
+  void fit(const VectorType &x, const VectorType &y, const VectorType &z, VectorType &weights, VectorType &affine, bool parallel) const;
+  void setupLocalPatches();
+  void addKernelSums(const Eigen::Ref<const VectorType> &cx, const Eigen::Ref<const VectorType> &cy, const Eigen::Ref<const VectorType> &ca, const QueryBlock &qx, const QueryBlock &qy, QueryBlock &z) const;
+  void evaluateBlock(const QueryBlock &qx, const QueryBlock &qy, QueryBlock &z) const;
+  Real evaluatePatch(const Patch &patch, Real x, Real y) const;
+  Real evaluateLocal(Real x, Real y) const;
+
   void setupInterpolator();
   friend BASE;
 };
@@ -102,31 +187,222 @@ class ThinPlateSplineInterpolator : public InterpolatorBase<ThinPlateSplineInter
 template<class Real>
 void ThinPlateSplineInterpolator<Real>::setupInterpolator()
 {
-  a = MatrixType(this->xView->rows(), 1);
-  b = MatrixType(this->xView->rows(), 3);
+  x_min = this->xView->minCoeff();
+  x_max = this->xView->maxCoeff();
+  y_min = this->yView->minCoeff();
+  y_max = this->yView->maxCoeff();
+
+  a.reset();
+  b.reset();
+  patches.reset();
+  if(local_patch_size > 0 && local_patch_size < this->xView->rows()) {
+    setupLocalPatches();
+    return;
+  }
+
+  auto new_a = std::make_shared<VectorType>();
+  auto new_b = std::make_shared<VectorType>();
+  fit(*this->xView, *this->yView, *this->zView, *new_a, *new_b, true);
+  a = std::move(new_a);
+  b = std::move(new_b);
+
+  return;
+}
+
+/**
+ * Solves the spline equations M a + N b = z, N^T a = 0 for the points (x, y, z). Instead of inverting M,
+ * the augmented (N+3)x(N+3) system is LU factorized, which is cheaper and numerically more stable.
+ */
+template<class Real>
+void ThinPlateSplineInterpolator<Real>::fit(const VectorType &x, const VectorType &y, const VectorType &z, VectorType &weights, VectorType &affine, bool parallel) const
+{
+  const int n = static_cast<int>(x.rows());
+
+  MatrixType L(n + 3, n + 3);
+  // M is symmetric, every column is filled independently
+  auto fill_column = [&](int j) {
+    for(int i = 0; i < n; i++)
+      L(i, j) = G(x(i), y(i), x(j), y(j));
+    L(n, j)     = 1;
+    L(n + 1, j) = x(j);
+    L(n + 2, j) = y(j);
+  };
+  if(parallel)
+    libInterpolate::Utils::parallel_for(0, n, fill_column, 64);
+  else
+    for(int j = 0; j < n; j++)
+      fill_column(j);
+
+  L.block(0, n, n, 3) = L.block(n, 0, 3, n).transpose();
+  L.block(n, n, 3, 3).setZero();
+
+  VectorType rhs(n + 3);
+  rhs.head(n) = z;
+  rhs.tail(3).setZero();
+
+  VectorType solution = L.partialPivLu().solve(rhs);
+  weights = solution.head(n);
+  affine = solution.tail(3);
+}
 
-  MatrixType M = MatrixType(this->xView->rows(), this->xView->rows());
-  MatrixType N = MatrixType(this->xView->rows(), 3);
+/**
+ * Splits the bounding box into tiles holding about a quarter of the patch size each. The patch of a tile
+ * holds the points in the tile grown by half a tile on every side, so the patches of neighbouring tiles
+ * overlap, and regions with few points are grown further until the fit has enough points.
+ */
+template<class Real>
+void ThinPlateSplineInterpolator<Real>::setupLocalPatches()
+{
+  const int n = static_cast<int>(this->xView->rows());
+  const Real width = x_max > x_min ? x_max - x_min : 1;
+  const Real height = y_max > y_min ? y_max - y_min : 1;
+
+  const Real num_tiles = static_cast<Real>(std::max(1, 4 * n / local_patch_size));
+  num_tiles_x = std::max(1, static_cast<int>(std::round(std::sqrt(num_tiles * width / height))));
+  num_tiles_y = std::max(1, static_cast<int>(std::round(num_tiles / static_cast<Real>(num_tiles_x))));
+  tile_width = width / static_cast<Real>(num_tiles_x);
+  tile_height = height / static_cast<Real>(num_tiles_y);
+
+  auto tile_x = [&](Real x) { return std::clamp(static_cast<int>((x - x_min) / tile_width), 0, num_tiles_x - 1); };
+  auto tile_y = [&](Real y) { return std::clamp(static_cast<int>((y - y_min) / tile_height), 0, num_tiles_y - 1); };
+
+  auto tile_index = [&](int i, int j) { return static_cast<size_t>(i * num_tiles_y + j); };
+
+  std::vector<std::vector<int>> tile_points(static_cast<size_t>(num_tiles_x * num_tiles_y));
+  for(int k = 0; k < n; k++)
+    tile_points[tile_index(tile_x(this->xView->coeff(k)), tile_y(this->yView->coeff(k)))].push_back(k);
+
+  const size_t min_points = static_cast<size_t>(std::max(3, local_patch_size / 2));
+  auto new_patches = std::make_shared<std::vector<Patch>>(tile_points.size());
+  libInterpolate::Utils::parallel_for(0, static_cast<int>(new_patches->size()), [&](int t) {
+    const int ti = t / num_tiles_y;
+    const int tj = t % num_tiles_y;
+    const Real cx = x_min + (static_cast<Real>(ti) + Real(0.5)) * tile_width;
+    const Real cy = y_min + (static_cast<Real>(tj) + Real(0.5)) * tile_height;
+
+    // margin is the half width of the patch in tiles
+    std::vector<int> members;
+    for(Real margin = 1;; margin *= Real(1.5)) {
+      members.clear();
+      const int reach = static_cast<int>(std::ceil(margin));
+      for(int i = std::max(0, ti - reach); i <= std::min(num_tiles_x - 1, ti + reach); i++) {
+        for(int j = std::max(0, tj - reach); j <= std::min(num_tiles_y - 1, tj + reach); j++) {
+          for(int k : tile_points[tile_index(i, j)]) {
+            if(std::abs(this->xView->coeff(k) - cx) <= margin * tile_width && std::abs(this->yView->coeff(k) - cy) <= margin * tile_height)
+              members.push_back(k);
+          }
+        }
+      }
+      if(members.size() >= min_points || reach >= std::max(num_tiles_x, num_tiles_y))
+        break;
+    }
 
-  // rows
-  for(int i = 0; i < this->xView->rows(); i++) {
-    // N
-    N(i, 0) = 1;
-    N(i, 1) = this->xView->coeff(i);
-    N(i, 2) = this->yView->coeff(i);
+    Patch &patch = (*new_patches)[static_cast<size_t>(t)];
+    const auto m = static_cast<Eigen::Index>(members.size());
+    patch.x.resize(m);
+    patch.y.resize(m);
+    VectorType z(m);
+    for(Eigen::Index k = 0; k < m; k++) {
+      const int member = members[static_cast<size_t>(k)];
+      patch.x(k) = this->xView->coeff(member);
+      patch.y(k) = this->yView->coeff(member);
+      z(k) = this->zView->coeff(member);
+    }
+    fit(patch.x, patch.y, z, patch.a, patch.b, false);
+  });
+  patches = std::move(new_patches);
+}
 
-    for(int j = 0; j < this->xView->rows(); j++) {
-      M(i, j) = G(this->xView->coeff(i), this->yView->coeff(i), this->xView->coeff(j), this->yView->coeff(j));
+/**
+ * Adds the sum of ca(i) G(qx(k), qy(k), cx(i), cy(i)) over all centres i to z(k). Centres are visited in
+ * tiles that stay in cache while the whole block of queries is evaluated against them, and the kernel
+ * is computed with array operations vectorized over the centres of a tile.
+ */
+template<class Real>
+void ThinPlateSplineInterpolator<Real>::addKernelSums(const Eigen::Ref<const VectorType> &cx, const Eigen::Ref<const VectorType> &cy, const Eigen::Ref<const VectorType> &ca, const QueryBlock &qx, const QueryBlock &qy, QueryBlock &z) const
+{
+  const int n = static_cast<int>(cx.rows());
+  KernelTile kernel;
+  for(int c0 = 0; c0 < n; c0 += centre_tile) {
+    const int nc = std::min(centre_tile, n - c0);
+    kernel.resize(nc);
+    for(int k = 0; k < qx.rows(); k++) {
+      kernel = (cx.segment(c0, nc).array() - qx(k)).square() + (cy.segment(c0, nc).array() - qy(k)).square();
+      // G = r^2 log(r) = r^2 log(r^2) / 2, and 0 where the query coincides with a centre
+      kernel = (kernel > 0).select(Real(0.5) * kernel * kernel.log(), Real(0));
+      z(k) += kernel.matrix().dot(ca.segment(c0, nc));
     }
   }
+}
 
-  MatrixType Minv = M.inverse();
-  MatrixType Ntra = N.transpose();
+template<class Real>
+void ThinPlateSplineInterpolator<Real>::evaluateBlock(const QueryBlock &qx, const QueryBlock &qy, QueryBlock &z) const
+{
+  auto inside = [&](int k) { return qx(k) >= x_min && qx(k) <= x_max && qy(k) >= y_min && qy(k) <= y_max; };
 
-  b = (Ntra * Minv * N).inverse() * Ntra * Minv * (*this->zView);
-  a = Minv * ((*this->zView) - N * b);
+  if(patches) {
+    for(int k = 0; k < qx.rows(); k++)
+      z(k) = inside(k) ? evaluateLocal(qx(k), qy(k)) : 0;
+    return;
+  }
 
-  return;
+  // no extrapolation, only the queries inside of the data are evaluated
+  QueryBlock ix, iy, iz;
+  Eigen::Array<int, Eigen::Dynamic, 1, 0, query_block, 1> index(qx.rows());
+  int n = 0;
+  for(int k = 0; k < qx.rows(); k++) {
+    if(inside(k))
+      index(n++) = k;
+  }
+  ix.resize(n);
+  iy.resize(n);
+  for(int k = 0; k < n; k++) {
+    ix(k) = qx(index(k));
+    iy(k) = qy(index(k));
+  }
+
+  iz = (*b)(0) + (*b)(1) * ix + (*b)(2) * iy;
+  addKernelSums(*this->xView, *this->yView, *a, ix, iy, iz);
+
+  z.setZero();
+  for(int k = 0; k < n; k++)
+    z(index(k)) = iz(k);
+}
+
+template<class Real>
+Real ThinPlateSplineInterpolator<Real>::evaluatePatch(const Patch &patch, Real x, Real y) const
+{
+  QueryBlock qx(1), qy(1), z(1);
+  qx(0) = x;
+  qy(0) = y;
+  z(0) = patch.b(0) + patch.b(1) * x + patch.b(2) * y;
+  addKernelSums(patch.x, patch.y, patch.a, qx, qy, z);
+  return z(0);
+}
+
+template<class Real>
+Real ThinPlateSplineInterpolator<Real>::evaluateLocal(Real x, Real y) const
+{
+  // bilinear blend of the patches of the (up to) four tiles whose centres surround (x, y)
+  const Real u = (x - x_min) / tile_width - Real(0.5);
+  const Real v = (y - y_min) / tile_height - Real(0.5);
+  const int i0 = std::clamp(static_cast<int>(std::floor(u)), 0, std::max(0, num_tiles_x - 2));
+  const int j0 = std::clamp(static_cast<int>(std::floor(v)), 0, std::max(0, num_tiles_y - 2));
+  const int i1 = std::min(i0 + 1, num_tiles_x - 1);
+  const int j1 = std::min(j0 + 1, num_tiles_y - 1);
+  const Real fu = i1 == i0 ? 0 : std::clamp(u - static_cast<Real>(i0), Real(0), Real(1));
+  const Real fv = j1 == j0 ? 0 : std::clamp(v - static_cast<Real>(j0), Real(0), Real(1));
+
+  Real f = 0;
+  auto add = [&](int i, int j, Real weight) {
+    if(weight > 0)
+      f += weight * evaluatePatch((*patches)[static_cast<size_t>(i * num_tiles_y + j)], x, y);
+  };
+  add(i0, j0, (1 - fu) * (1 - fv));
+  add(i0, j1, (1 - fu) * fv);
+  add(i1, j0, fu * (1 - fv));
+  add(i1, j1, fu * fv);
+  return f;
 }
 
 template<class Real>
@@ -146,17 +422,20 @@ Real ThinPlateSplineInterpolator<Real>::operator()(Real x, Real y) const
   BASE::checkData();
 
   // no extrapolation...
-  if(x < this->xView->minCoeff() || x > this->xView->maxCoeff() || y < this->yView->minCoeff() || y > this->yView->maxCoeff()) {
+  if(x < x_min || x > x_max || y < y_min || y > y_max) {
     return 0;
   }
 
-  MatrixType Gx(1, this->xView->rows());
-  for(int i = 0; i < this->xView->rows(); i++)
-    Gx(i) = G(x, y, this->xView->coeff(i), this->yView->coeff(i));
+  if(patches)
+    return evaluateLocal(x, y);
 
-  Real f = (Gx * a)(0, 0) + b(0) + b(1) * x + b(2) * y;
+  QueryBlock qx(1), qy(1), z(1);
+  qx(0) = x;
+  qy(0) = y;
+  z(0) = (*b)(0) + (*b)(1) * x + (*b)(2) * y;
+  addKernelSums(*this->xView, *this->yView, *a, qx, qy, z);
 
-  return f;
+  return z(0);
 }
 
 }  // namespace _2D
@@ -0,0 +1,95 @@
+#pragma once
+
+/** @file LruCache.hpp
+  * @brief A bounded, thread-safe least-recently-used cache.
+  */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace libInterpolate
+{
+namespace Utils
+{
+/**
+ * Holds at most capacity values. The keys are spread over a fixed number of shards that are locked
+ * independently, so concurrent lookups of different keys rarely contend. Each shard evicts its least
+ * recently used value once it holds more than its share of the capacity.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache
+{
+ public:
+  static constexpr size_t num_shards = 16;
+
+  explicit LruCache(size_t max_values = 0) { setCapacity(max_values); }
+
+  void setCapacity(size_t new_capacity)
+  {
+    capacity = new_capacity;
+    shard_capacity = std::max<size_t>(1, (capacity + num_shards - 1) / num_shards);
+    clear();
+  }
+
+  size_t getCapacity() const { return capacity; }
+
+  void clear()
+  {
+    for(auto &shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.values.clear();
+      shard.index.clear();
+    }
+  }
+
+  /**
+   * Returns the value for key, computing it with compute() if it is not cached. compute() runs without
+   * holding a lock, so two threads may compute the same value, and only one of the results is kept.
+   */
+  template<typename F>
+  Value get(const Key &key, F compute) const
+  {
+    Shard &shard = shards[Hash{}(key) % num_shards];
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto it = shard.index.find(key);
+      if(it != shard.index.end()) {
+        shard.values.splice(shard.values.begin(), shard.values, it->second);
+        return it->second->second;
+      }
+    }
+
+    Value value = compute();
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if(shard.index.find(key) == shard.index.end()) {
+      shard.values.emplace_front(key, value);
+      shard.index.emplace(key, shard.values.begin());
+      if(shard.values.size() > shard_capacity) {
+        shard.index.erase(shard.values.back().first);
+        shard.values.pop_back();
+      }
+    }
+    return value;
+  }
+
+ private:
+  struct Shard {
+    std::mutex mutex;
+    // most recently used first
+    std::list<std::pair<Key, Value>> values;
+    std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator, Hash> index;
+  };
+
+  size_t capacity = 0;
+  size_t shard_capacity = 1;
+  mutable std::array<Shard, num_shards> shards;
+};
+}  // namespace Utils
+}  // namespace libInterpolate
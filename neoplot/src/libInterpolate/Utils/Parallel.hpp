@@ -0,0 +1,80 @@
+#pragma once
+
+/** @file Parallel.hpp
+  * @brief Minimal fork-join helper for splitting loops across threads.
+  */
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace libInterpolate
+{
+namespace Utils
+{
+/// Runs run_chunk(c) for every c in [0, num_chunks) and returns once all of them are done.
+using executor_t = void (*)(int num_chunks, const std::function<void(int)> &run_chunk);
+
+/// The executor of parallel_for, nullptr (the default) runs the chunks on new threads.
+inline std::atomic<executor_t> &executor()
+{
+  static std::atomic<executor_t> instance{nullptr};
+  return instance;
+}
+
+/**
+ * Lets parallel_for run its chunks on a thread pool of the application. Without one every call
+ * starts and joins a thread per chunk, which costs tens of microseconds per thread and call.
+ */
+inline void set_executor(executor_t new_executor)
+{
+  executor().store(new_executor);
+}
+
+/**
+ * Calls f(i) for every i in [begin, end). The range is split into one contiguous chunk per hardware
+ * thread, chunks are never smaller than min_chunk_size. The calling thread processes the last chunk
+ * and the function returns once all chunks are done. f must not throw.
+ */
+template<typename F>
+void parallel_for(int begin, int end, F f, int min_chunk_size = 1)
+{
+  const int n = end - begin;
+  if(n <= 0)
+    return;
+
+  const int max_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  const int max_chunks = std::max(1, std::min(max_threads, n / std::max(1, min_chunk_size)));
+  const int chunk_size = (n + max_chunks - 1) / max_chunks;
+  const int num_chunks = (n + chunk_size - 1) / chunk_size;
+
+  auto run_chunk = [begin, end, chunk_size, &f](int chunk) {
+    const int chunk_begin = begin + chunk * chunk_size;
+    const int chunk_end = std::min(end, chunk_begin + chunk_size);
+    for(int i = chunk_begin; i < chunk_end; ++i)
+      f(i);
+  };
+
+  if(num_chunks == 1) {
+    run_chunk(0);
+    return;
+  }
+  if(const auto pool = executor().load()) {
+    pool(num_chunks, run_chunk);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(static_cast<size_t>(num_chunks - 1));
+  for(int chunk = 0; chunk < num_chunks - 1; ++chunk)
+    threads.emplace_back(run_chunk, chunk);
+
+  run_chunk(num_chunks - 1);
+
+  for(auto &t : threads)
+    t.join();
+}
+}  // namespace Utils
+}  // namespace libInterpolate
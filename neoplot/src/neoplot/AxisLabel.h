@@ -1,5 +1,6 @@
 #pragma once
 #include <juce_gui_basics/juce_gui_basics.h>
+#include "PlotResources.h"
 #include "PlotTools.h"
 
 namespace neo::plot
@@ -32,7 +33,7 @@ public:
     {
         g.setColour(m_settings.style.axisLabelText);
         const auto fontSize = m_settings.style.axisLabelFontSize;
-        g.setFont(fontSize);
+        g.setFont(m_resources->getFont(fontSize));
 
         const auto height = fontSize;
         const auto width = height * 2;
@@ -189,5 +190,6 @@ private:
     AxisLabelType m_type;
     PlotGrid<T>& m_grid;
     std::string m_title;
+    juce::SharedResourcePointer<PlotResources> m_resources;
 };
 } // namespace neo::plot
@@ -1,35 +1,54 @@
 #pragma once
+#include "PlotAudioFile.h"
+#include "PlotCrosshair.h"
 #include "PlotData.h"
 #include "PlotGrid.h"
+#include "PlotHeatmap.h"
 #include "AxisLabel.h"
 #include "PlotLines.h"
 #include "PlotMouseInteraction.h"
 #include "PlotLegend.h"
 #include "PlotMouseLabel.h"
 #include "PlotOverlay.h"
-#include <BinaryData.h>
+#include "PlotResources.h"
+#include "PlotScatter.h"
+#include "PlotSmoothing.h"
+#include "PlotSpectrogram.h"
+#include "PlotViewModel.h"
+#include "PlotWarpCache.h"
 
 namespace neo::plot
 {
 template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 class NeoPlot : public juce::Component
+    , private PlotViewModel<T>::Listener
 {
 public:
     NeoPlot()
         : m_plotLine(settings, m_data)
         , m_grid(settings)
+        , m_spectrogram(settings)
+        , m_heatmap(settings)
+        , m_scatter(settings)
+        , m_audioFile(settings)
         , m_mouseInteraction(settings, m_data)
         , m_overlay(settings, m_data)
         , m_legend(settings, m_data)
-        , m_mouseLabel(settings, m_mouseInteraction)
+        , m_mouseLabel(settings, m_mouseInteraction, m_data)
+        , m_crosshair(settings, m_data, m_mouseInteraction)
     {
         getLookAndFeel().setDefaultSansSerifTypeface(getFont());
 
         addAndMakeVisible(m_grid);
+        addAndMakeVisible(m_spectrogram);
+        addAndMakeVisible(m_heatmap);
+        addAndMakeVisible(m_scatter);
+        addAndMakeVisible(m_audioFile);
         addAndMakeVisible(m_labelLeft);
         addAndMakeVisible(m_labelBottom);
         addAndMakeVisible(m_plotLine);
+        addAndMakeVisible(m_crosshair);
         addAndMakeVisible(m_mouseLabel);
         addAndMakeVisible(m_mouseInteraction);
         if (settings.legend)
@@ -38,10 +57,35 @@ public:
         }
 
         addMouseListener(this, true);
+
+        // the lines keep their paths while only the mouse moves
+        m_mouseInteraction.onMouseHover = [this]
+        {
+            m_crosshair.repaint();
+            m_mouseLabel.repaint();
+            m_mouseInteraction.repaint();
+        };
+        m_mouseInteraction.onViewChange = [this]
+        {
+            m_plotLine.beginInteraction();
+            if (m_viewModel != nullptr)
+            {
+                m_viewModel->setXRange(settings.xMin, settings.xMax, this);
+            }
+        };
+    }
+
+    ~NeoPlot() override
+    {
+        if (m_viewModel != nullptr)
+        {
+            m_viewModel->removeListener(this);
+        }
     }
 
     void paint(juce::Graphics& g) override
     {
+        ++m_numPaintedFrames;
         g.fillAll(settings.style.background);
         // g.setColour(juce::Colours::white);
         // g.drawRect(getLocalBounds());
@@ -57,7 +101,12 @@ public:
         settings.plotBounds = bounds;
 
         m_grid.setBounds(settings.plotBounds);
+        m_spectrogram.setBounds(settings.plotBounds);
+        m_heatmap.setBounds(settings.plotBounds);
+        m_scatter.setBounds(settings.plotBounds);
+        m_audioFile.setBounds(settings.plotBounds);
         m_plotLine.setBounds(settings.plotBounds);
+        m_crosshair.setBounds(settings.plotBounds);
         m_mouseInteraction.setBounds(settings.plotBounds);
         m_overlay.setBounds(settings.plotBounds);
 
@@ -74,7 +123,7 @@ public:
 
         m_mouseLabel.setBounds(settings.plotBounds.getX() + 10,
                                settings.plotBounds.getBottom() - 55,
-                               75,
+                               150,
                                50);
 
         resizedOverlay();
@@ -86,20 +135,60 @@ public:
     {
         if (settings.type == PlotType::logarithmic && !data.isAlreadyWarped)
         {
-            data.xData = warp(data.xData);
-            data.yData = warp(data.yData);
-        }
-        if (settings.yAxisInDb)
-        {
-            plot::lin_to_db(data.yData);
+            if (data.sharedXData != nullptr)
+            {
+                data.sharedXData = m_warpCache->getWarped(data.sharedXData);
+            }
+            else
+            {
+                data.xData = warp(data.xData);
+            }
+            if (data.sharedYData != nullptr)
+            {
+                data.sharedYData = m_warpCache->getWarped(data.sharedYData);
+            }
+            else
+            {
+                data.yData = warp(data.yData);
+            }
         }
         m_data.push_back(data);
         m_legend.dataAdded();
+        m_plotLine.dataChanged();
+        m_crosshair.dataChanged();
+        m_mouseInteraction.dataChanged();
         if (fitBounds)
             automaticPlotBounds(settings, m_data);
         resized();
     }
 
+    [[nodiscard]] auto getNumData() const -> std::size_t { return m_data.size(); }
+
+    // for updating a series in place, call dataUpdated() after writing to it
+    auto getData(std::size_t id) -> PlotData<T>& { return m_data[id]; }
+
+    void dataUpdated()
+    {
+        m_plotLine.dataChanged();
+        m_crosshair.dataChanged();
+        m_mouseInteraction.dataChanged();
+        repaint();
+    }
+
+    [[nodiscard]] auto getNumPaintedFrames() const -> std::size_t
+    {
+        return m_numPaintedFrames;
+    }
+
+    // the data stays linear, so this only changes how it is displayed
+    void setYAxisInDb(bool inDb, bool fitBounds = true)
+    {
+        settings.yAxisInDb = inDb;
+        if (fitBounds)
+            automaticPlotBounds(settings, m_data);
+        repaint();
+    }
+
     void setDataVisible(size_t id, bool visible)
     {
         if (id < m_data.size())
@@ -109,12 +198,125 @@ public:
         }
     }
 
+    // for PlotType::spectrogram, the x-axis shows the history in seconds up to now at 0
+    void prepareSpectrogram(std::size_t numBins,
+                            double binWidth,
+                            double framesPerSecond,
+                            double historySeconds)
+    {
+        m_spectrogram.prepare(numBins, binWidth, framesPerSecond, historySeconds);
+        setDefaultBounds(static_cast<T>(-m_spectrogram.getHistorySeconds()),
+                         static_cast<T>(0),
+                         static_cast<T>(m_spectrogram.getMinFrequency()),
+                         static_cast<T>(m_spectrogram.getMaxFrequency()));
+    }
+
+    // linear magnitudes of the numBins given to prepareSpectrogram()
+    void addSpectrogramFrame(const T* magnitudes) { m_spectrogram.addFrame(magnitudes); }
+
+    auto getSpectrogram() -> PlotSpectrogram<T>& { return m_spectrogram; }
+
+    // gridded data drawn below the lines, z holds all y values of x[0] first
+    void setHeatmapData(const std::vector<T>& x,
+                        const std::vector<T>& y,
+                        const std::vector<T>& z,
+                        HeatmapInterpolation interpolation =
+                            HeatmapInterpolation::bicubicInterpolation,
+                        bool fitBounds = true)
+    {
+        m_heatmap.setData(x, y, z, interpolation);
+        if (fitBounds)
+            setDefaultBounds(x.front(), x.back(), y.front(), y.back());
+    }
+
+    // scattered points interpolated with a thin plate spline, a localPatchSize of a few
+    // hundred points keeps large data sets fast
+    void setHeatmapScatteredData(const std::vector<T>& x,
+                                 const std::vector<T>& y,
+                                 const std::vector<T>& z,
+                                 int localPatchSize = 0,
+                                 bool fitBounds = true)
+    {
+        m_heatmap.setScatteredData(x, y, z, localPatchSize);
+        if (fitBounds)
+        {
+            const auto [xMin, xMax, yMin, yMax] = m_heatmap.getDataBounds();
+            setDefaultBounds(xMin, xMax, yMin, yMax);
+        }
+    }
+
+    auto getHeatmap() -> PlotHeatmap<T>& { return m_heatmap; }
+
+    // unsorted points, e.g. millions of measurements, drawn as a density image where
+    // they are dense and as markers of markerColour where they are sparse. The arrays are
+    // kept by the plot, move them in to avoid a copy.
+    void setScatterData(std::vector<T> x,
+                        std::vector<T> y,
+                        juce::Colour markerColour = juce::Colours::white,
+                        bool fitBounds = true)
+    {
+        m_scatter.setData(std::move(x), std::move(y));
+        m_scatter.setMarkerColour(markerColour);
+        if (fitBounds && m_scatter.hasData())
+        {
+            const auto [xMin, xMax, yMin, yMax] = m_scatter.getDataBounds();
+            setDefaultBounds(xMin, xMax, yMin, yMax);
+        }
+    }
+
+    auto getScatter() -> PlotScatter<T>& { return m_scatter; }
+
+    // waveform of a wav, aiff or flac file, shown right away and refined while the file
+    // is summarised in the background, channel -1 shows all channels
+    auto openAudioFile(const juce::File& file, int channel = -1, bool fitBounds = true)
+        -> juce::Result
+    {
+        const auto result = m_audioFile.open(file, channel);
+        if (result.wasOk() && fitBounds)
+            setDefaultBounds(
+                T(0), static_cast<T>(m_audioFile.getLengthInSeconds()), T(-1), T(1));
+        return result;
+    }
+
+    auto getAudioFile() -> PlotAudioFile<T>& { return m_audioFile; }
+
+    // links the x axis to the other plots of viewModel, a plot joining the group takes
+    // over its x range, or gives it its own if it is the first one, nullptr unlinks it
+    void setViewModel(std::shared_ptr<PlotViewModel<T>> viewModel)
+    {
+        if (m_viewModel != nullptr)
+        {
+            m_viewModel->removeListener(this);
+        }
+        m_viewModel = std::move(viewModel);
+        m_plotLine.setViewModel(m_viewModel.get());
+        if (m_viewModel == nullptr)
+        {
+            return;
+        }
+
+        m_viewModel->addListener(this);
+        if (const auto range = m_viewModel->getXRange())
+        {
+            xRangeChanged(range->first, range->second);
+        }
+        else
+        {
+            m_viewModel->setXRange(settings.xMin, settings.xMax, this);
+        }
+    }
+
+    [[nodiscard]] auto getViewModel() const -> std::shared_ptr<PlotViewModel<T>>
+    {
+        return m_viewModel;
+    }
+
     PlotSettings<T> settings;
 
+    // loaded once and shared by all plots
     auto getFont() -> juce::Typeface::Ptr
     {
-        return juce::Typeface::createSystemTypefaceFor(BinaryData::JetBrainsMono_ttf,
-                                                       BinaryData::JetBrainsMono_ttfSize);
+        return m_resources->getTypeface();
     }
 
     auto setDefaultBounds(std::optional<T> xMin,
@@ -131,14 +333,31 @@ public:
     }
 
 private:
+    void xRangeChanged(const T xMin, const T xMax) override
+    {
+        settings.xMin = xMin;
+        settings.xMax = xMax;
+        m_plotLine.beginInteraction();
+        repaint();
+    }
+
+    juce::SharedResourcePointer<PlotResources> m_resources;
+    std::shared_ptr<PlotViewModel<T>> m_viewModel;
     PlotLines<T> m_plotLine;
     PlotGrid<T> m_grid;
+    PlotSpectrogram<T> m_spectrogram;
+    PlotHeatmap<T> m_heatmap;
+    PlotScatter<T> m_scatter;
+    PlotAudioFile<T> m_audioFile;
     AxisLabel<T> m_labelBottom {settings, m_grid, AxisLabel<T>::AxisLabelType::XBottom};
     AxisLabel<T> m_labelLeft {settings, m_grid, AxisLabel<T>::AxisLabelType::YLeft};
     PlotMouseInteraction<T> m_mouseInteraction;
     PlotLegend<T> m_legend;
     PlotMouseLabel<T> m_mouseLabel;
     PlotOverlay<T> m_overlay;
+    PlotCrosshair<T> m_crosshair;
     std::vector<PlotData<T>> m_data;
+    juce::SharedResourcePointer<PlotWarpCache<T>> m_warpCache;
+    std::size_t m_numPaintedFrames = 0;
 };
 } // namespace neo::plot
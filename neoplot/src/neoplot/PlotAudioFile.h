@@ -0,0 +1,594 @@
+#pragma once
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <array>
+#include <atomic>
+#include <optional>
+#include <tuple>
+#include "PlotSettings.h"
+#include "PlotTools.h"
+
+namespace neo::plot
+{
+// Waveform of an audio file that is read on demand instead of being decoded up front.
+// Opening a file only reads its header, a background thread then summarises the
+// samples into the minimum and maximum of blocks of 256 to 65536 samples. It visits
+// the chunks of the file in bit reversed order, so the whole envelope shows up coarse
+// right away and fills in while the build goes on. Views with fewer samples than a
+// summary block per pixel read just the samples they show from the file.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class PlotAudioFile : public juce::Component
+    , private juce::AsyncUpdater
+{
+public:
+    explicit PlotAudioFile(const PlotSettings<T>& settings)
+        : m_settings(settings)
+    {
+        setInterceptsMouseClicks(false, false);
+    }
+
+    ~PlotAudioFile() override { close(); }
+
+    // channel -1 shows the envelope of all channels
+    auto open(const juce::File& file, const int channel = -1) -> juce::Result
+    {
+        close();
+
+        // plots that never open a file do not register the formats or create a thread
+        if (!m_formats.has_value())
+        {
+            m_formats.emplace();
+            m_summaryThread = std::make_unique<SummaryThread>(*this);
+        }
+
+        m_summaryReader = createReader(file);
+        m_viewReader = createReader(file);
+        if (m_summaryReader == nullptr || m_viewReader == nullptr)
+        {
+            close();
+            return juce::Result::fail("Unsupported audio file: "
+                                      + file.getFullPathName());
+        }
+
+        if (channel < -1 || channel >= static_cast<int>(m_viewReader->numChannels))
+        {
+            close();
+            return juce::Result::fail("No channel " + juce::String(channel) + " in "
+                                      + file.getFullPathName());
+        }
+        m_channel = channel;
+        m_sampleRate = m_viewReader->sampleRate;
+        m_length = m_viewReader->lengthInSamples;
+        m_numChunks =
+            static_cast<std::size_t>((m_length + CHUNK_SAMPLES - 1) / CHUNK_SAMPLES);
+
+        // written by the build thread, a chunk is only read once it is done
+        auto blockSize = static_cast<juce::int64>(BLOCK_SAMPLES);
+        for (auto& level: m_levels)
+        {
+            level.blockSize = blockSize;
+            const auto numBlocks =
+                static_cast<std::size_t>((m_length + blockSize - 1) / blockSize);
+            level.minimum.reset(new float[numBlocks]);
+            level.maximum.reset(new float[numBlocks]);
+            blockSize *= LEVEL_FACTOR;
+        }
+        m_chunkDone.reset(new std::atomic<bool>[m_numChunks]());
+        m_numChunksDone = 0;
+
+        m_samplesBegin = m_samplesEnd = 0;
+        m_summaryThread->startThread();
+        repaint();
+        return juce::Result::ok();
+    }
+
+    void close()
+    {
+        if (m_summaryThread != nullptr)
+        {
+            m_summaryThread->stopThread(1000);
+        }
+        cancelPendingUpdate();
+        m_summaryReader.reset();
+        m_viewReader.reset();
+        m_length = 0;
+        m_numChunks = 0;
+        repaint();
+    }
+
+    [[nodiscard]] auto hasFile() const -> bool { return m_viewReader != nullptr; }
+
+    [[nodiscard]] auto getLengthInSeconds() const -> double
+    {
+        return m_sampleRate > 0 ? static_cast<double>(m_length) / m_sampleRate : 0;
+    }
+
+    // fraction of the file that is summarised
+    [[nodiscard]] auto getSummaryProgress() const -> double
+    {
+        return m_numChunks == 0 ? 1.
+                                : static_cast<double>(m_numChunksDone)
+                                      / static_cast<double>(m_numChunks);
+    }
+
+    void setColour(const juce::Colour clr)
+    {
+        m_colour = clr;
+        repaint();
+    }
+
+    void setLineThickness(const float lineThickness)
+    {
+        m_lineThickness = lineThickness;
+        repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        const auto width = getWidth();
+        if (!hasFile() || width <= 0 || m_length == 0)
+        {
+            return;
+        }
+
+        const auto first = sampleAt(0);
+        const auto last = sampleAt(width);
+        if (last <= first)
+        {
+            return;
+        }
+
+        const auto samplesPerPixel = static_cast<double>(last - first) / width;
+        juce::Path path;
+        auto filled = false;
+        if (samplesPerPixel < 1.)
+        {
+            pathThroughSamples(path, first, last);
+        }
+        else
+        {
+            m_columnMinimum.resize(static_cast<std::size_t>(width));
+            m_columnMaximum.resize(static_cast<std::size_t>(width));
+            m_columnValid.resize(static_cast<std::size_t>(width));
+            if (samplesPerPixel < BLOCK_SAMPLES)
+            {
+                envelopeFromSamples(first, last);
+            }
+            else
+            {
+                envelopeFromSummary(samplesPerPixel);
+            }
+            filled = m_settings.waveformEnvelope;
+            if (filled)
+            {
+                outlineEnvelope(path);
+            }
+            else
+            {
+                pathThroughEnvelope(path);
+            }
+        }
+
+        g.setColour(m_colour);
+        if (filled)
+        {
+            g.fillPath(path);
+        }
+        else
+        {
+            g.strokePath(path, juce::PathStrokeType(m_lineThickness));
+        }
+    }
+
+private:
+    static constexpr juce::int64 BLOCK_SAMPLES = 256;
+    static constexpr juce::int64 LEVEL_FACTOR = 4;
+    static constexpr std::size_t NUM_LEVELS = 5;
+    // the blocks of the coarsest level, the unit of work of the summary thread
+    static constexpr juce::int64 CHUNK_SAMPLES = 65536;
+
+    struct Level
+    {
+        juce::int64 blockSize = 0;
+        std::unique_ptr<float[]> minimum, maximum;
+    };
+
+    // the formats are registered once and shared by all plots
+    struct Formats
+    {
+        Formats() { manager.registerBasicFormats(); }
+
+        juce::AudioFormatManager manager;
+    };
+
+    class SummaryThread : public juce::Thread
+    {
+    public:
+        explicit SummaryThread(PlotAudioFile& owner)
+            : juce::Thread("PlotAudioFile summary")
+            , m_owner(owner)
+        {
+        }
+
+        void run() override { m_owner.buildSummary(*this); }
+
+    private:
+        PlotAudioFile& m_owner;
+    };
+
+    auto createReader(const juce::File& file) -> std::unique_ptr<juce::AudioFormatReader>
+    {
+        // wav and aiff are mapped, so reads are plain memory accesses
+        if (auto* format =
+                (*m_formats)->manager.findFormatForFileExtension(file.getFileExtension()))
+        {
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(
+                format->createMemoryMappedReader(file));
+            if (mapped != nullptr && mapped->mapEntireFile())
+            {
+                return mapped;
+            }
+        }
+        return std::unique_ptr<juce::AudioFormatReader>(
+            (*m_formats)->manager.createReaderFor(file));
+    }
+
+    // i with its numBits lowest bits reversed
+    static auto reverseBits(std::size_t i, const int numBits) -> std::size_t
+    {
+        std::size_t reversed = 0;
+        for (int bit = 0; bit < numBits; ++bit, i >>= 1)
+        {
+            reversed = (reversed << 1) | (i & 1);
+        }
+        return reversed;
+    }
+
+    void buildSummary(const juce::Thread& thread)
+    {
+        const auto numChannels = static_cast<int>(m_summaryReader->numChannels);
+        juce::AudioBuffer<float> buffer(numChannels, static_cast<int>(CHUNK_SAMPLES));
+
+        int numBits = 0;
+        while ((static_cast<std::size_t>(1) << numBits) < m_numChunks)
+        {
+            ++numBits;
+        }
+
+        auto lastUpdate = juce::Time::getMillisecondCounter();
+        for (std::size_t i = 0; i < (static_cast<std::size_t>(1) << numBits); ++i)
+        {
+            const auto chunk = reverseBits(i, numBits);
+            if (chunk >= m_numChunks)
+            {
+                continue;
+            }
+            if (thread.threadShouldExit())
+            {
+                return;
+            }
+
+            const auto start = static_cast<juce::int64>(chunk) * CHUNK_SAMPLES;
+            const auto numSamples =
+                static_cast<int>(std::min(CHUNK_SAMPLES, m_length - start));
+            m_summaryReader->read(
+                buffer.getArrayOfWritePointers(), numChannels, start, numSamples);
+
+            // the finest level from the samples, every further level from the one below
+            auto& finest = m_levels[0];
+            for (juce::int64 offset = 0; offset < numSamples; offset += BLOCK_SAMPLES)
+            {
+                const auto n =
+                    static_cast<int>(std::min(BLOCK_SAMPLES, numSamples - offset));
+                auto range = blockRange(buffer, static_cast<int>(offset), n);
+                const auto block =
+                    static_cast<std::size_t>((start + offset) / BLOCK_SAMPLES);
+                finest.minimum[block] = range.getStart();
+                finest.maximum[block] = range.getEnd();
+            }
+            for (std::size_t level = 1; level < NUM_LEVELS; ++level)
+            {
+                const auto& lower = m_levels[level - 1];
+                auto& upper = m_levels[level];
+                const auto lowerEnd =
+                    (start + numSamples + lower.blockSize - 1) / lower.blockSize;
+                for (auto block = start / upper.blockSize;
+                     block * LEVEL_FACTOR < lowerEnd;
+                     ++block)
+                {
+                    const auto* minimum = lower.minimum.get() + block * LEVEL_FACTOR;
+                    const auto* maximum = lower.maximum.get() + block * LEVEL_FACTOR;
+                    const auto n =
+                        std::min(LEVEL_FACTOR, lowerEnd - block * LEVEL_FACTOR);
+                    upper.minimum[static_cast<std::size_t>(block)] =
+                        *std::min_element(minimum, minimum + n);
+                    upper.maximum[static_cast<std::size_t>(block)] =
+                        *std::max_element(maximum, maximum + n);
+                }
+            }
+
+            m_chunkDone[chunk].store(true, std::memory_order_release);
+            ++m_numChunksDone;
+
+            const auto now = juce::Time::getMillisecondCounter();
+            if (now - lastUpdate > UPDATE_INTERVAL_MS)
+            {
+                lastUpdate = now;
+                triggerAsyncUpdate();
+            }
+        }
+        triggerAsyncUpdate();
+    }
+
+    // envelope of the shown channels over n samples from offset
+    auto blockRange(const juce::AudioBuffer<float>& buffer,
+                    const int offset,
+                    const int n) const -> juce::Range<float>
+    {
+        auto minimum = std::numeric_limits<float>::max();
+        auto maximum = std::numeric_limits<float>::lowest();
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            if (m_channel >= 0 && channel != m_channel)
+            {
+                continue;
+            }
+            const auto* samples = buffer.getReadPointer(channel, offset);
+            const auto [lowest, highest] = std::minmax_element(samples, samples + n);
+            minimum = std::min(minimum, *lowest);
+            maximum = std::max(maximum, *highest);
+        }
+        return {minimum, maximum};
+    }
+
+    void handleAsyncUpdate() override { repaint(); }
+
+    // first sample at or after the left edge of a pixel column
+    auto sampleAt(const int column) const -> juce::int64
+    {
+        const auto seconds =
+            static_cast<double>(getXValue(static_cast<T>(column), m_settings));
+        return std::clamp(static_cast<juce::int64>(std::ceil(seconds * m_sampleRate)),
+                          static_cast<juce::int64>(0),
+                          m_length);
+    }
+
+    void envelopeFromSummary(const double samplesPerPixel)
+    {
+        // the coarsest level that still has at least one block per pixel
+        std::size_t levelIndex = 0;
+        while (levelIndex + 1 < NUM_LEVELS
+               && static_cast<double>(m_levels[levelIndex + 1].blockSize)
+                      <= samplesPerPixel)
+        {
+            ++levelIndex;
+        }
+        const auto& level = m_levels[levelIndex];
+        const auto blocksPerChunk =
+            static_cast<std::size_t>(CHUNK_SAMPLES / level.blockSize);
+
+        auto begin = sampleAt(0);
+        for (std::size_t column = 0; column < m_columnValid.size(); ++column)
+        {
+            const auto end = std::max(begin + 1, sampleAt(static_cast<int>(column) + 1));
+            auto minimum = std::numeric_limits<float>::max();
+            auto maximum = std::numeric_limits<float>::lowest();
+            bool valid = false;
+            for (auto block = static_cast<std::size_t>(begin / level.blockSize);
+                 begin < m_length
+                 && block <= static_cast<std::size_t>((std::min(end, m_length) - 1)
+                                                      / level.blockSize);
+                 ++block)
+            {
+                if (m_chunkDone[block / blocksPerChunk].load(std::memory_order_acquire))
+                {
+                    minimum = std::min(minimum, level.minimum[block]);
+                    maximum = std::max(maximum, level.maximum[block]);
+                    valid = true;
+                }
+            }
+            m_columnMinimum[column] = minimum;
+            m_columnMaximum[column] = maximum;
+            m_columnValid[column] = valid;
+            begin = end;
+        }
+    }
+
+    void envelopeFromSamples(const juce::int64 first, const juce::int64 last)
+    {
+        readSamples(first, last);
+
+        auto begin = first;
+        for (std::size_t column = 0; column < m_columnValid.size(); ++column)
+        {
+            const auto end = std::min(
+                last, std::max(begin + 1, sampleAt(static_cast<int>(column) + 1)));
+            m_columnValid[column] = end > begin;
+            if (end > begin)
+            {
+                const auto* samples = m_samples.data() + (begin - m_samplesBegin);
+                const auto [lowest, highest] =
+                    std::minmax_element(samples, samples + (end - begin));
+                m_columnMinimum[column] = *lowest;
+                m_columnMaximum[column] = *highest;
+            }
+            begin = std::max(begin, end);
+        }
+    }
+
+    void pathThroughEnvelope(juce::Path& path) const
+    {
+        bool connected = false;
+        for (std::size_t column = 0; column < m_columnValid.size(); ++column)
+        {
+            if (!m_columnValid[column])
+            {
+                connected = false;
+                continue;
+            }
+            const auto x = static_cast<float>(column) + 0.5f;
+            const auto yMinimum = getYPosition(
+                toDisplayValue(static_cast<T>(m_columnMinimum[column]), m_settings),
+                m_settings);
+            const auto yMaximum = getYPosition(
+                toDisplayValue(static_cast<T>(m_columnMaximum[column]), m_settings),
+                m_settings);
+            if (connected)
+            {
+                path.lineTo(x, static_cast<float>(yMinimum));
+            }
+            else
+            {
+                path.startNewSubPath(x, static_cast<float>(yMinimum));
+            }
+            path.lineTo(x, static_cast<float>(yMaximum));
+            connected = true;
+        }
+    }
+
+    // one closed outline per run of columns with an envelope, the maxima forward and the
+    // minima backward, widened by the line thickness so it covers what the stroked
+    // zigzag covered
+    void outlineEnvelope(juce::Path& path) const
+    {
+        const auto numColumns = m_columnValid.size();
+        for (std::size_t runBegin = 0; runBegin < numColumns;)
+        {
+            if (!m_columnValid[runBegin])
+            {
+                ++runBegin;
+                continue;
+            }
+            auto runEnd = runBegin;
+            while (runEnd < numColumns && m_columnValid[runEnd])
+            {
+                ++runEnd;
+            }
+
+            for (auto column = runBegin; column < runEnd; ++column)
+            {
+                const auto x = static_cast<float>(column) + 0.5f;
+                const auto top = getColumnExtent(column).first;
+                if (column == runBegin)
+                    path.startNewSubPath(x, top);
+                else
+                    path.lineTo(x, top);
+            }
+            for (auto column = runEnd; column-- > runBegin;)
+            {
+                const auto x = static_cast<float>(column) + 0.5f;
+                path.lineTo(x, getColumnExtent(column).second);
+            }
+            path.closeSubPath();
+            runBegin = runEnd;
+        }
+    }
+
+    // the highest and lowest pixel row the envelope of a column covers, pixel y grows
+    // downwards
+    auto getColumnExtent(const std::size_t column) const -> std::pair<float, float>
+    {
+        const auto yMinimum = static_cast<float>(getYPosition(
+            toDisplayValue(static_cast<T>(m_columnMinimum[column]), m_settings),
+            m_settings));
+        const auto yMaximum = static_cast<float>(getYPosition(
+            toDisplayValue(static_cast<T>(m_columnMaximum[column]), m_settings),
+            m_settings));
+        const auto halfThickness = m_lineThickness / 2.f;
+        return {std::min(yMinimum, yMaximum) - halfThickness,
+                std::max(yMinimum, yMaximum) + halfThickness};
+    }
+
+    void pathThroughSamples(juce::Path& path, juce::int64 first, juce::int64 last)
+    {
+        // one sample beyond each edge, so the line leaves the view
+        first = std::max(static_cast<juce::int64>(0), first - 1);
+        last = std::min(m_length, last + 1);
+        readSamples(first, last);
+
+        for (auto sample = first; sample < last; ++sample)
+        {
+            const auto x = getXPosition(
+                static_cast<T>(static_cast<double>(sample) / m_sampleRate), m_settings);
+            const auto index = static_cast<std::size_t>(sample - m_samplesBegin);
+            const auto value = static_cast<T>(m_samples[index]);
+            const auto y = getYPosition(toDisplayValue(value, m_settings), m_settings);
+            if (sample == first)
+            {
+                path.startNewSubPath(static_cast<float>(x), static_cast<float>(y));
+            }
+            else
+            {
+                path.lineTo(static_cast<float>(x), static_cast<float>(y));
+            }
+        }
+    }
+
+    // makes [first, last) available in m_samples, reading a margin around it so small
+    // pans are served without touching the file again
+    void readSamples(const juce::int64 first, const juce::int64 last)
+    {
+        if (first >= m_samplesBegin && last <= m_samplesEnd)
+        {
+            return;
+        }
+
+        const auto margin = (last - first) / 2;
+        m_samplesBegin = std::max(static_cast<juce::int64>(0), first - margin);
+        m_samplesEnd = std::min(m_length, last + margin);
+        const auto numSamples = static_cast<int>(m_samplesEnd - m_samplesBegin);
+        const auto numChannels = static_cast<int>(m_viewReader->numChannels);
+
+        m_readBuffer.setSize(numChannels, numSamples, false, false, true);
+        m_viewReader->read(m_readBuffer.getArrayOfWritePointers(),
+                           numChannels,
+                           m_samplesBegin,
+                           numSamples);
+
+        // with all channels shown, the sample furthest from zero represents the frame
+        m_samples.resize(static_cast<std::size_t>(numSamples));
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (m_channel >= 0)
+            {
+                m_samples[static_cast<std::size_t>(i)] =
+                    m_readBuffer.getReadPointer(m_channel)[i];
+                continue;
+            }
+            auto value = m_readBuffer.getReadPointer(0)[i];
+            for (int channel = 1; channel < numChannels; ++channel)
+            {
+                const auto candidate = m_readBuffer.getReadPointer(channel)[i];
+                value = std::abs(candidate) > std::abs(value) ? candidate : value;
+            }
+            m_samples[static_cast<std::size_t>(i)] = value;
+        }
+    }
+
+    static constexpr juce::uint32 UPDATE_INTERVAL_MS = 50;
+
+    const PlotSettings<T>& m_settings;
+    std::optional<juce::SharedResourcePointer<Formats>> m_formats;
+    std::unique_ptr<juce::AudioFormatReader> m_summaryReader, m_viewReader;
+    std::unique_ptr<SummaryThread> m_summaryThread;
+
+    int m_channel = -1;
+    double m_sampleRate = 0;
+    juce::int64 m_length = 0;
+    std::size_t m_numChunks = 0;
+    std::array<Level, NUM_LEVELS> m_levels;
+    std::unique_ptr<std::atomic<bool>[]> m_chunkDone;
+    std::atomic<std::size_t> m_numChunksDone {0};
+
+    juce::Colour m_colour = juce::Colours::white;
+    float m_lineThickness = 1.f;
+
+    // only touched on the message thread
+    juce::AudioBuffer<float> m_readBuffer;
+    std::vector<float> m_samples;
+    juce::int64 m_samplesBegin = 0, m_samplesEnd = 0;
+    std::vector<float> m_columnMinimum, m_columnMaximum;
+    std::vector<bool> m_columnValid;
+};
+} // namespace neo::plot
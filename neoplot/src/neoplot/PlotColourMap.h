@@ -0,0 +1,89 @@
+#pragma once
+#include <Eigen/Eigen>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <array>
+
+namespace neo::plot
+{
+// Lookup table from normalised values to opaque pixels, for image based plot types.
+class PlotColourMap
+{
+public:
+    static constexpr int SIZE = 256;
+
+    explicit PlotColourMap(const juce::ColourGradient& gradient)
+    {
+        for (int i = 0; i < SIZE; ++i)
+        {
+            m_lut[static_cast<std::size_t>(i)] =
+                gradient.getColourAtPosition(static_cast<double>(i) / (SIZE - 1))
+                    .getPixelARGB();
+        }
+    }
+
+    PlotColourMap()
+        : PlotColourMap(getDefaultGradient())
+    {
+    }
+
+    // dark purple over red and orange to light yellow
+    static auto getDefaultGradient() -> juce::ColourGradient
+    {
+        juce::ColourGradient gradient(juce::Colour(0, 0, 4), 0.f, 0.f,
+                                      juce::Colour(252, 253, 191), 1.f, 0.f,
+                                      false);
+        gradient.addColour(0.25, juce::Colour(81, 18, 124));
+        gradient.addColour(0.5, juce::Colour(183, 55, 121));
+        gradient.addColour(0.75, juce::Colour(252, 137, 97));
+        return gradient;
+    }
+
+    [[nodiscard]] auto getPixel(const int index) const -> juce::PixelARGB
+    {
+        return m_lut[static_cast<std::size_t>(juce::jlimit(0, SIZE - 1, index))];
+    }
+
+    // maps values between minimum and maximum onto the table, values outside are clamped
+    template <class T>
+    void map(const T* values,
+             const std::size_t numValues,
+             const T minimum,
+             const T maximum,
+             juce::PixelARGB* destination,
+             const int destinationStride = 1) const
+    {
+        const auto scale = static_cast<float>(SIZE - 1) / static_cast<float>(maximum - minimum);
+        const auto offset = static_cast<float>(minimum);
+
+        // the table positions are computed in vectorised blocks, only the lookup is scalar
+        std::array<float, BLOCK_SIZE> positionBuffer;
+        std::array<int, BLOCK_SIZE> indexBuffer;
+        for (std::size_t start = 0; start < numValues; start += BLOCK_SIZE)
+        {
+            const auto count = static_cast<Eigen::Index>(std::min(BLOCK_SIZE, numValues - start));
+            Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>> in(values + start, count);
+            Eigen::Map<Eigen::ArrayXf> position(positionBuffer.data(), count);
+            Eigen::Map<Eigen::ArrayXi> index(indexBuffer.data(), count);
+
+            position = (in.template cast<float>() - offset) * scale + 0.5f;
+            // compared this way round NaN ends up at the bottom of the table
+            position = (position >= 0.f).select(position, 0.f);
+            position = (position <= static_cast<float>(SIZE) - 0.5f)
+                           .select(position, static_cast<float>(SIZE) - 0.5f);
+            index = position.cast<int>();
+
+            auto* out = destination + static_cast<long>(start) * destinationStride;
+            for (Eigen::Index i = 0; i < count; ++i)
+            {
+                out[static_cast<long>(i) * destinationStride] =
+                    m_lut[static_cast<std::size_t>(indexBuffer[static_cast<std::size_t>(i)])];
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t BLOCK_SIZE = 256;
+
+    std::array<juce::PixelARGB, SIZE> m_lut;
+};
+} // namespace neo::plot
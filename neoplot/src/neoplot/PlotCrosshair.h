@@ -0,0 +1,170 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <optional>
+#include "PlotData.h"
+#include "PlotMouseInteraction.h"
+#include "PlotResources.h"
+#include "PlotSettings.h"
+#include "PlotTools.h"
+
+namespace neo::plot
+{
+// Vertical line at the mouse with the value of every visible series at its x. A value is
+// found with a binary search and read between the two neighbouring points, or from the
+// interpolator of the series over a few points around them, so no series is scanned.
+// The values are kept while the mouse stays in the same column of an unchanged view.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class PlotCrosshair : public juce::Component
+{
+public:
+    PlotCrosshair(const PlotSettings<T>& settings,
+                  const std::vector<PlotData<T>>& data,
+                  const PlotMouseInteraction<T>& mouseInteraction)
+        : m_settings(settings)
+        , m_data(data)
+        , m_mouseInteraction(mouseInteraction)
+    {
+        setInterceptsMouseClicks(false, false);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        if (!m_settings.crosshair || !m_mouseInteraction.isMouseOverPlot())
+        {
+            return;
+        }
+
+        const auto column = m_mouseInteraction.getMousePosition().x;
+        updateValues(getXValue(static_cast<T>(column), m_settings));
+
+        g.setColour(m_settings.style.crosshair);
+        g.drawVerticalLine(column, 0.f, static_cast<float>(getHeight()));
+
+        const auto fontsize = m_settings.style.mouseLabelTextSize;
+        g.setFont(m_resources->getFont(fontsize));
+        auto numLines = 0;
+        for (const auto& value: m_values)
+        {
+            numLines += value.has_value() ? 1 : 0;
+        }
+        if (numLines == 0)
+        {
+            return;
+        }
+
+        // next to the line, on the side with more room
+        const auto boxWidth = 150;
+        const auto boxHeight = static_cast<int>(fontsize) * numLines + 4;
+        const auto boxX = column + boxWidth + 10 < getWidth() ? column + 5
+                                                              : column - boxWidth - 5;
+        auto box = juce::Rectangle<int>(boxX, 5, boxWidth, boxHeight);
+        g.setColour(m_settings.style.crosshairBackground);
+        g.fillRect(box);
+
+        box.reduce(4, 2);
+        for (std::size_t id = 0; id < m_values.size(); ++id)
+        {
+            if (!m_values[id])
+            {
+                continue;
+            }
+            const auto& data = m_data[id];
+            g.setColour(data.clr);
+            g.drawFittedText(
+                data.name + ": "
+                    + getStringForValue(toDisplayValue(*m_values[id], m_settings),
+                                        m_settings.yUnit,
+                                        2),
+                box.removeFromTop(static_cast<int>(fontsize)),
+                juce::Justification::centredLeft,
+                1);
+        }
+    }
+
+    // drops the cached values, has to be called when the data changes
+    void dataChanged() { m_valuesX.reset(); }
+
+    // value of data at x, nothing outside of its points
+    static auto getValueAt(const PlotData<T>& data, const T x) -> std::optional<T>
+    {
+        const auto& xData = data.getXData();
+        const auto& yData = data.getYData();
+        const auto size = std::min(xData.size(), yData.size());
+        if (size == 0 || !(x >= xData.front() && x <= xData[size - 1]))
+        {
+            return std::nullopt;
+        }
+
+        const auto upper = static_cast<std::size_t>(
+            std::lower_bound(xData.begin(), xData.begin() + static_cast<long>(size), x)
+            - xData.begin());
+        if (upper == 0 || xData[upper] == x)
+        {
+            return yData[upper];
+        }
+        const auto lower = upper - 1;
+
+        if (data.interpolation == linearInterpolation || size < 3)
+        {
+            const auto t = (x - xData[lower]) / (xData[upper] - xData[lower]);
+            return yData[lower] + t * (yData[upper] - yData[lower]);
+        }
+
+        // a few points on each side are enough for the shape of the curve at x
+        const auto begin = static_cast<long>(lower >= INTERPOLATION_POINTS
+                                                 ? lower - INTERPOLATION_POINTS + 1
+                                                 : 0);
+        const auto end = static_cast<long>(std::min(size, upper + INTERPOLATION_POINTS));
+        if (data.interpolation == cubicSplineInterpolation)
+        {
+            _1D::CubicSplineInterpolator<T> interpolator;
+            interpolator.setData(xData.begin() + begin,
+                                 xData.begin() + end,
+                                 yData.begin() + begin,
+                                 yData.begin() + end);
+            return interpolator(x);
+        }
+        _1D::MonotonicInterpolator<T> interpolator;
+        interpolator.setData(xData.begin() + begin,
+                             xData.begin() + end,
+                             yData.begin() + begin,
+                             yData.begin() + end);
+        return interpolator(x);
+    }
+
+private:
+    static constexpr std::size_t INTERPOLATION_POINTS = 4;
+
+    void updateValues(const T x)
+    {
+        bool visibilityChanged = m_valuesVisible.size() != m_data.size();
+        for (std::size_t id = 0; !visibilityChanged && id < m_data.size(); ++id)
+        {
+            visibilityChanged = m_valuesVisible[id] != m_data[id].visible;
+        }
+        if (m_valuesX == x && !visibilityChanged)
+        {
+            return;
+        }
+        m_valuesX = x;
+        m_values.resize(m_data.size());
+        m_valuesVisible.resize(m_data.size());
+        for (std::size_t id = 0; id < m_data.size(); ++id)
+        {
+            m_valuesVisible[id] = m_data[id].visible;
+            m_values[id] =
+                m_data[id].visible ? getValueAt(m_data[id], x) : std::optional<T>();
+        }
+    }
+
+    const PlotSettings<T>& m_settings;
+    const std::vector<PlotData<T>>& m_data;
+    const PlotMouseInteraction<T>& m_mouseInteraction;
+    juce::SharedResourcePointer<PlotResources> m_resources;
+    // the x the values were read at, it changes with the mouse column and the view
+    std::optional<T> m_valuesX;
+    std::vector<std::optional<T>> m_values;
+    std::vector<bool> m_valuesVisible;
+};
+} // namespace neo::plot
@@ -1,14 +1,29 @@
 #pragma once
 #include <juce_gui_basics/juce_gui_basics.h>
+#include <memory>
 
 namespace neo::plot
 {
+// how values between the points of a series are read, e.g. by the crosshair
+enum DataInterpolation
+{
+    linearInterpolation,
+    cubicSplineInterpolation,
+    monotonicInterpolation
+};
+
 template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 struct PlotData
 {
     std::vector<T> xData;
     std::vector<T> yData;
+    // x values shared with other series, e.g. the channels of one recording, used
+    // instead of xData when set
+    std::shared_ptr<const std::vector<T>> sharedXData;
+    // y values shared with other plots, used instead of yData when set, the plots of
+    // a PlotViewModel then reduce them only once for the same view
+    std::shared_ptr<const std::vector<T>> sharedYData;
     std::vector<T> xDataReduced;
     std::vector<T> yDataReduced;
     std::vector<T> yDataReducedWaveformMin;
@@ -22,6 +37,7 @@ struct PlotData
     bool isWaveform = false;
     bool isAlreadyWarped = false;
     bool hovered = false;
+    DataInterpolation interpolation = linearInterpolation;
 
     explicit PlotData(std::size_t initialSize = 0,
                       juce::Colour clr_ = juce::Colours::transparentWhite)
@@ -39,8 +55,36 @@ struct PlotData
         clr = clr_;
     }
 
+    PlotData(std::shared_ptr<const std::vector<T>> sharedXData_,
+             std::vector<T>& yData_,
+             juce::Colour clr_ = juce::Colours::transparentWhite)
+    {
+        sharedXData = std::move(sharedXData_);
+        yData = yData_;
+        clr = clr_;
+    }
+
+    PlotData(std::shared_ptr<const std::vector<T>> sharedXData_,
+             std::shared_ptr<const std::vector<T>> sharedYData_,
+             juce::Colour clr_ = juce::Colours::transparentWhite)
+    {
+        sharedXData = std::move(sharedXData_);
+        sharedYData = std::move(sharedYData_);
+        clr = clr_;
+    }
+
     explicit PlotData(const std::size_t numPoints) { prepare(numPoints); }
 
+    [[nodiscard]] auto getXData() const -> const std::vector<T>&
+    {
+        return sharedXData != nullptr ? *sharedXData : xData;
+    }
+
+    [[nodiscard]] auto getYData() const -> const std::vector<T>&
+    {
+        return sharedYData != nullptr ? *sharedYData : yData;
+    }
+
     void prepare(const std::size_t numPoints)
     {
         xDataReduced.resize(numPoints, 0.);
@@ -0,0 +1,273 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include "PlotData.h"
+#include "PlotParallel.h"
+
+namespace neo::plot
+{
+namespace detail
+{
+inline auto isBlank(const char c) -> bool { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline auto isDelimiter(const char c) -> bool
+{
+    return isBlank(c) || c == ',' || c == ';';
+}
+
+// position after the first line break at or after pos - 1, so a line starting at pos
+// belongs to the chunk starting at pos
+inline auto lineStartFrom(const char* text, const std::size_t size, const std::size_t pos)
+    -> std::size_t
+{
+    if (pos == 0)
+    {
+        return 0;
+    }
+    if (pos >= size)
+    {
+        return size;
+    }
+    const auto* lineBreak =
+        static_cast<const char*>(std::memchr(text + pos - 1, '\n', size - pos + 1));
+    return lineBreak == nullptr ? size : static_cast<std::size_t>(lineBreak - text) + 1;
+}
+
+// the number [begin, end) with nothing else around it
+template <class T>
+auto parseNumber(const char* begin, const char* end, T& value) -> bool
+{
+    if (begin == end)
+    {
+        return false;
+    }
+#if defined(__cpp_lib_to_chars)
+    const auto [next, error] = std::from_chars(begin, end, value);
+    return error == std::errc() && next == end;
+#else
+    // without a floating point from_chars, e.g. in libc++ before LLVM 20, strtod reads a
+    // terminated copy of the number
+    const auto length = static_cast<std::size_t>(end - begin);
+    // from_chars reads no hexadecimal numbers
+    const auto isHex = [](const char c) { return c == 'x' || c == 'X'; };
+    if (std::find_if(begin, end, isHex) != end)
+    {
+        return false;
+    }
+    char buffer[64];
+    std::string longNumber;
+    const char* number = buffer;
+    if (length < sizeof(buffer))
+    {
+        std::memcpy(buffer, begin, length);
+        buffer[length] = '\0';
+    }
+    else
+    {
+        longNumber.assign(begin, end);
+        number = longNumber.c_str();
+    }
+    char* next = nullptr;
+    const auto parsed = std::strtod(number, &next);
+    if (next != number + length)
+    {
+        return false;
+    }
+    value = static_cast<T>(parsed);
+    return true;
+#endif
+}
+
+// the numbers in columns xColumn and yColumn of the line [begin, end), columns are
+// separated by blanks, a comma or a semicolon
+template <class T>
+auto parseLine(const char* begin,
+               const char* end,
+               const std::size_t xColumn,
+               const std::size_t yColumn,
+               T& x,
+               T& y) -> bool
+{
+    const auto lastColumn = std::max(xColumn, yColumn);
+    auto* p = begin;
+    for (std::size_t column = 0; column <= lastColumn; ++column)
+    {
+        while (p < end && isBlank(*p))
+        {
+            ++p;
+        }
+        auto* tokenBegin = p;
+        while (p < end && !isDelimiter(*p))
+        {
+            ++p;
+        }
+
+        if (column == xColumn || column == yColumn)
+        {
+            // from_chars does not accept a leading plus
+            if (tokenBegin + 1 < p && *tokenBegin == '+' && tokenBegin[1] != '-')
+            {
+                ++tokenBegin;
+            }
+            T value;
+            if (!parseNumber(tokenBegin, p, value))
+            {
+                return false;
+            }
+            (column == xColumn ? x : y) = value;
+        }
+
+        while (p < end && isBlank(*p))
+        {
+            ++p;
+        }
+        if (p < end && (*p == ',' || *p == ';'))
+        {
+            ++p;
+        }
+    }
+    return true;
+}
+} // namespace detail
+
+// Loads columns xColumn and yColumn of a text file, e.g. a CSV export of a
+// measurement, into the xData and yData of data. The file is memory mapped and
+// split into line aligned chunks that are parsed in parallel with std::from_chars,
+// lines without a number in both columns, like headers and comments, are skipped.
+// progress is called from the loading threads, one call at a time, with the fraction
+// of the file parsed so far and cancels the loading if it returns false. data is only
+// changed if the whole file was loaded.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+auto loadPlotData(const juce::File& file,
+                  PlotData<T>& data,
+                  const std::size_t xColumn = 0,
+                  const std::size_t yColumn = 1,
+                  const std::function<bool(double)>& progress = {}) -> juce::Result
+{
+    jassert(xColumn != yColumn);
+
+    if (!file.existsAsFile())
+    {
+        return juce::Result::fail("File does not exist: " + file.getFullPathName());
+    }
+
+    const juce::MemoryMappedFile mappedFile(file, juce::MemoryMappedFile::readOnly);
+    const auto size = mappedFile.getSize();
+    const auto* text = static_cast<const char*>(mappedFile.getData());
+    if (text == nullptr && size > 0)
+    {
+        return juce::Result::fail("File could not be mapped: " + file.getFullPathName());
+    }
+
+    // held for the whole load, so both parallel loops run on the same pool
+    const juce::SharedResourcePointer<PlotThreadPool> threadPool;
+
+    constexpr std::size_t CHUNK_BYTES = 4 << 20;
+    const auto numChunks =
+        std::max<std::size_t>(1, (size + CHUNK_BYTES - 1) / CHUNK_BYTES);
+    std::vector<std::size_t> chunkStarts(numChunks + 1);
+    for (std::size_t chunk = 0; chunk <= numChunks; ++chunk)
+    {
+        chunkStarts[chunk] = detail::lineStartFrom(text, size, chunk * CHUNK_BYTES);
+    }
+
+    std::vector<std::vector<T>> xChunks(numChunks), yChunks(numChunks);
+    std::atomic<std::size_t> bytesDone {0};
+    std::atomic<bool> cancelled {false};
+    std::mutex progressLock;
+
+    parallelFor(0,
+                numChunks,
+                1,
+                [&](const std::size_t chunk, std::size_t)
+                {
+                    if (cancelled)
+                    {
+                        return;
+                    }
+
+                    const auto* p = text + chunkStarts[chunk];
+                    const auto* chunkEnd = text + chunkStarts[chunk + 1];
+                    auto& x = xChunks[chunk];
+                    auto& y = yChunks[chunk];
+                    // a guess of about 16 characters per line
+                    x.reserve(static_cast<std::size_t>(chunkEnd - p) / 16);
+                    y.reserve(x.capacity());
+
+                    while (p < chunkEnd)
+                    {
+                        const auto* lineEnd = static_cast<const char*>(
+                            std::memchr(p, '\n', static_cast<std::size_t>(chunkEnd - p)));
+                        if (lineEnd == nullptr)
+                        {
+                            lineEnd = chunkEnd;
+                        }
+
+                        T xValue, yValue;
+                        if (detail::parseLine(
+                                p, lineEnd, xColumn, yColumn, xValue, yValue))
+                        {
+                            x.push_back(xValue);
+                            y.push_back(yValue);
+                        }
+                        p = lineEnd + 1;
+                    }
+
+                    const auto done = bytesDone +=
+                        chunkStarts[chunk + 1] - chunkStarts[chunk];
+                    if (progress)
+                    {
+                        // an empty file is done at once
+                        const auto fraction = size == 0 ? 1.
+                                                        : static_cast<double>(done)
+                                                              / static_cast<double>(size);
+                        const std::lock_guard<std::mutex> lock(progressLock);
+                        if (!cancelled && !progress(fraction))
+                        {
+                            cancelled = true;
+                        }
+                    }
+                });
+
+    if (cancelled)
+    {
+        return juce::Result::fail("Loading was cancelled");
+    }
+
+    std::vector<std::size_t> offsets(numChunks + 1, 0);
+    for (std::size_t chunk = 0; chunk < numChunks; ++chunk)
+    {
+        offsets[chunk + 1] = offsets[chunk] + xChunks[chunk].size();
+    }
+
+    // the loaded values replace shared arrays the series showed before
+    data.sharedXData = nullptr;
+    data.sharedYData = nullptr;
+    data.xData.resize(offsets.back());
+    data.yData.resize(offsets.back());
+    parallelFor(0,
+                numChunks,
+                1,
+                [&](const std::size_t chunk, std::size_t)
+                {
+                    std::copy(xChunks[chunk].begin(),
+                              xChunks[chunk].end(),
+                              data.xData.begin() + static_cast<long>(offsets[chunk]));
+                    std::copy(yChunks[chunk].begin(),
+                              yChunks[chunk].end(),
+                              data.yData.begin() + static_cast<long>(offsets[chunk]));
+                    std::vector<T>().swap(xChunks[chunk]);
+                    std::vector<T>().swap(yChunks[chunk]);
+                });
+
+    return juce::Result::ok();
+}
+} // namespace neo::plot
@@ -60,7 +60,7 @@ private:
         m_xGridPositionsToLabel.clear();
         m_yGridPositionsToLabel.clear();
 
-        if (m_settings.type == PlotType::linear)
+        if (m_settings.type != PlotType::logarithmic)
         {
             const auto stepX = calculateGridSpaceX(m_settings.plotBounds.getWidth(),
                                                    PIXELS_BETWEEN_GRIDS_DENSE);
@@ -74,12 +74,15 @@ private:
         }
         else
         {
-            m_xGridPositions =
-                std::vector<T> {10,  20,  30,  40,  50,  60,  70,  80,   90,   100,
-                                200, 300, 400, 500, 600, 700, 800, 900,  1e3,  2e3,
-                                3e3, 4e3, 5e3, 6e3, 7e3, 8e3, 9e3, 10e3, 20e3, 30e3};
-            m_xGridPositionsToLabel = std::vector<T> {
-                10, 20, 40, 60, 100, 200, 400, 600, 1e3, 2e3, 4e3, 6e3, 10e3, 20e3, 30e3};
+            m_xGridPositions = LOG_GRID_POSITIONS;
+            m_xGridPositionsToLabel = LOG_GRID_POSITIONS_TO_LABEL;
+        }
+
+        if (m_settings.type == PlotType::spectrogram)
+        {
+            m_yGridPositions = LOG_GRID_POSITIONS;
+            m_yGridPositionsToLabel = LOG_GRID_POSITIONS_TO_LABEL;
+            return;
         }
 
         const auto stepY = calculateGridSpaceY(m_settings.plotBounds.getHeight(),
@@ -96,12 +99,16 @@ private:
 
     auto drawZeroLines(juce::Graphics& g)
     {
-        if (m_settings.type == PlotType::linear)
+        if (m_settings.type != PlotType::logarithmic)
         {
             const auto zeroX = getXPosition(static_cast<T>(0.), m_settings);
             g.drawVerticalLine(
                 zeroX, 0.f, static_cast<float>(m_settings.plotBounds.getHeight()));
         }
+        if (m_settings.type == PlotType::spectrogram)
+        {
+            return;
+        }
         const auto zeroY = getYPosition(static_cast<T>(0.), m_settings);
         g.drawHorizontalLine(
             zeroY, 0.f, static_cast<float>(m_settings.plotBounds.getWidth()));
@@ -146,6 +153,11 @@ private:
     }
 
     std::vector<T> ALLOWED_VALUES {1, 2, 5, 10};
+    const std::vector<T> LOG_GRID_POSITIONS {
+        10,  20,  30,  40,  50,  60,  70,  80,  90,  100, 200,  300,  400,  500,  600,
+        700, 800, 900, 1e3, 2e3, 3e3, 4e3, 5e3, 6e3, 7e3, 8e3, 9e3, 10e3, 20e3, 30e3};
+    const std::vector<T> LOG_GRID_POSITIONS_TO_LABEL {
+        10, 20, 40, 60, 100, 200, 400, 600, 1e3, 2e3, 4e3, 6e3, 10e3, 20e3, 30e3};
     static constexpr int PIXELS_BETWEEN_GRIDS_DENSE = 60;
     static constexpr int PIXELS_BETWEEN_GRIDS_Y = 50;
     static constexpr int PIXELS_BETWEEN_GRIDS_SPARSE = 100;
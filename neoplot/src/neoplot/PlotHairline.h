@@ -0,0 +1,172 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <vector>
+
+namespace neo::plot
+{
+// Anti-aliased polylines about one pixel wide, drawn straight into an ARGB image or a
+// single channel mask. JUCE's stroker builds joins and caps for every segment and fills
+// the outline as a polygon, which is most of the work for a reduced series with one
+// segment per pixel column.
+// Here a segment only sets the coverage of the two pixels it passes between in every
+// row or column it crosses, as in Xiaolin Wu's algorithm. The coverage of a line is the
+// maximum over its segments, so joins are not drawn twice, and is blended into the image
+// once after all segments are added, only at the pixels the line touched.
+class PlotHairline
+{
+public:
+    // widest line, in pixels of the image, drawn as a hairline. A hairline always covers
+    // about one pixel, so wider lines would come out thinner than the stroker draws them.
+    static constexpr float MAX_WIDTH = 1.f;
+
+    // image has to stay alive and keep its size while lines are drawn, scale maps the
+    // coordinates of the lines onto pixels. Only the pixels of area are drawn, at the top
+    // left of the image, e.g. for an image of only a part of a plot.
+    void setImage(juce::Image& image, const float scale, const juce::Rectangle<int> area)
+    {
+        jassert(area.getWidth() <= image.getWidth());
+        jassert(area.getHeight() <= image.getHeight());
+        m_image = &image;
+        m_scale = scale;
+        m_origin = area.getPosition().toFloat();
+        m_width = area.getWidth();
+        m_height = area.getHeight();
+        // the coverage is cleared after every line, so it only grows for larger areas
+        const auto size = static_cast<std::size_t>(m_width * m_height);
+        if (m_coverage.size() < size)
+        {
+            m_coverage.resize(size, 0.f);
+        }
+    }
+
+    void draw(const std::vector<juce::Point<float>>& points,
+              const juce::Colour colour,
+              const float width)
+    {
+        if (m_image == nullptr || points.empty())
+        {
+            return;
+        }
+
+        // thinner lines are dimmed like the stroker covers them only partially
+        m_intensity = std::min(1.f, width * m_scale);
+
+        auto previous = points.front() * m_scale - m_origin;
+        addSegment(previous, previous);
+        for (std::size_t i = 1; i < points.size(); ++i)
+        {
+            const auto next = points[i] * m_scale - m_origin;
+            addSegment(previous, next);
+            previous = next;
+        }
+        blend(colour.getPixelARGB());
+    }
+
+private:
+    void addSegment(const juce::Point<float> start, const juce::Point<float> end)
+    {
+        // pixel centres at whole coordinates
+        auto x0 = start.x - 0.5f, y0 = start.y - 0.5f;
+        auto x1 = end.x - 0.5f, y1 = end.y - 0.5f;
+        if (!std::isfinite(x0 + y0 + x1 + y1))
+        {
+            return;
+        }
+
+        // steps along the longer axis, one or two pixels of the other one per step
+        const auto steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+        if (steep)
+        {
+            std::swap(x0, y0);
+            std::swap(x1, y1);
+        }
+        if (x0 > x1)
+        {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+        }
+        const auto gradient = x1 > x0 ? (y1 - y0) / (x1 - x0) : 0.f;
+        const auto majorSize = static_cast<float>(steep ? m_height : m_width);
+        const auto minorSize = static_cast<float>(steep ? m_width : m_height);
+
+        const auto first = static_cast<int>(std::lround(std::max(x0, 0.f)));
+        const auto last = static_cast<int>(std::lround(std::min(x1, majorSize - 1.f)));
+        for (auto major = first; major <= last; ++major)
+        {
+            const auto minor =
+                y0 + gradient * (std::clamp(static_cast<float>(major), x0, x1) - x0);
+            if (minor <= -1.f || minor >= minorSize)
+            {
+                continue;
+            }
+            const auto lower = static_cast<int>(std::floor(minor));
+            const auto fraction = minor - static_cast<float>(lower);
+            cover(steep, major, lower, 1.f - fraction);
+            cover(steep, major, lower + 1, fraction);
+        }
+    }
+
+    void cover(const bool steep, const int major, const int minor, const float coverage)
+    {
+        const auto x = steep ? minor : major;
+        const auto y = steep ? major : minor;
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height || coverage <= 0.f)
+        {
+            return;
+        }
+
+        // column major, as the steep segments of dense lines walk down columns
+        const auto index = static_cast<std::size_t>(x * m_height + y);
+        auto& pixel = m_coverage[index];
+        if (pixel == 0.f)
+        {
+            m_touched.push_back(index);
+        }
+        pixel = std::max(pixel, coverage * m_intensity);
+    }
+
+    // blends colour with the coverage into the image and clears the coverage again,
+    // only at the pixels the line touched
+    void blend(const juce::PixelARGB colour)
+    {
+        juce::Image::BitmapData bitmap(*m_image, juce::Image::BitmapData::readWrite);
+        if (bitmap.pixelFormat == juce::Image::SingleChannel)
+        {
+            blendPixels<juce::PixelAlpha>(bitmap, colour);
+        }
+        else
+        {
+            blendPixels<juce::PixelARGB>(bitmap, colour);
+        }
+    }
+
+    template <class Pixel>
+    void blendPixels(const juce::Image::BitmapData& bitmap, const juce::PixelARGB colour)
+    {
+        const auto height = static_cast<std::size_t>(m_height);
+        for (const auto index: m_touched)
+        {
+            const auto alpha =
+                static_cast<juce::uint32>(m_coverage[index] * 255.f + 0.5f);
+            m_coverage[index] = 0.f;
+            if (alpha > 0)
+            {
+                const auto x = static_cast<int>(index / height);
+                const auto y = static_cast<int>(index % height);
+                reinterpret_cast<Pixel*>(bitmap.getPixelPointer(x, y))
+                    ->blend(colour, alpha);
+            }
+        }
+        m_touched.clear();
+    }
+
+    juce::Image* m_image = nullptr;
+    float m_scale = 1.f;
+    juce::Point<float> m_origin;
+    int m_width = 0, m_height = 0;
+    float m_intensity = 1.f;
+    // coverage of the line being drawn, zero outside of the pixels it touched
+    std::vector<float> m_coverage;
+    std::vector<std::size_t> m_touched;
+};
+} // namespace neo::plot
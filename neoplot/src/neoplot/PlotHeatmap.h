@@ -0,0 +1,296 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <optional>
+#include <tuple>
+#include "PlotColourMap.h"
+#include "PlotParallel.h"
+#include "PlotResources.h"
+#include "PlotSettings.h"
+#include "PlotTools.h"
+
+namespace neo::plot
+{
+enum HeatmapInterpolation
+{
+    bilinearInterpolation,
+    bicubicInterpolation,
+    thinPlateSplineInterpolation
+};
+
+// Smooth image of gridded 2D data, e.g. a directivity over frequency and angle, or of
+// scattered measurements through a thin plate spline. The data is resampled at the pixel
+// centres in parallel blocks of rows, where the grid cell of every pixel column and row
+// is only searched once. The colour mapped image is kept until the view, the size, the
+// levels or the data change.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class PlotHeatmap : public juce::Component
+{
+public:
+    explicit PlotHeatmap(const PlotSettings<T>& settings)
+        : m_settings(settings)
+    {
+        setInterceptsMouseClicks(false, false);
+    }
+
+    // x and y ascending, z holds all y.size() values of x[0], then those of x[1] and so on
+    void setData(const std::vector<T>& x,
+                 const std::vector<T>& y,
+                 const std::vector<T>& z,
+                 const HeatmapInterpolation interpolation =
+                     HeatmapInterpolation::bicubicInterpolation)
+    {
+        jassert(x.size() >= 2 && y.size() >= 2 && z.size() == x.size() * y.size());
+        acquireThreadPool();
+
+        m_interpolation = interpolation;
+        if (interpolation == HeatmapInterpolation::bicubicInterpolation)
+        {
+            m_bicubic.setData(x, y, z);
+        }
+        else
+        {
+            m_bilinear.setData(x, y, z);
+        }
+
+        m_xFirst = x.front();
+        m_xLast = x.back();
+        m_yFirst = y.front();
+        m_yLast = y.back();
+        dataChanged(z);
+    }
+
+    // scattered points, the spline is fitted to local patches of about localPatchSize
+    // points, or to all points if it is 0
+    void setScatteredData(const std::vector<T>& x,
+                          const std::vector<T>& y,
+                          const std::vector<T>& z,
+                          const int localPatchSize = 0)
+    {
+        jassert(x.size() >= 3 && y.size() == x.size() && z.size() == x.size());
+        acquireThreadPool();
+
+        m_interpolation = HeatmapInterpolation::thinPlateSplineInterpolation;
+        m_thinPlateSpline.setLocalPatchSize(localPatchSize);
+        m_thinPlateSpline.setData(x, y, z);
+
+        const auto [xMinimum, xMaximum] = std::minmax_element(x.begin(), x.end());
+        const auto [yMinimum, yMaximum] = std::minmax_element(y.begin(), y.end());
+        m_xFirst = *xMinimum;
+        m_xLast = *xMaximum;
+        m_yFirst = *yMinimum;
+        m_yLast = *yMaximum;
+        dataChanged(z);
+    }
+
+    // values mapped to the ends of the colour map, by default the range of the data
+    void setLevelRange(std::optional<T> minimum, std::optional<T> maximum)
+    {
+        m_minimumLevel = minimum;
+        m_maximumLevel = maximum;
+        repaint();
+    }
+
+    void setColourMap(const PlotColourMap& colourMap)
+    {
+        m_colourMap = std::make_shared<const PlotColourMap>(colourMap);
+        ++m_dataVersion;
+        repaint();
+    }
+
+    [[nodiscard]] auto hasData() const -> bool { return m_hasData; }
+
+    [[nodiscard]] auto getDataBounds() const -> std::tuple<T, T, T, T>
+    {
+        return {m_xFirst, m_xLast, m_yFirst, m_yLast};
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        if (!m_hasData || getWidth() <= 0 || getHeight() <= 0)
+        {
+            return;
+        }
+
+        const auto key = CacheKey {m_settings.xMin,
+                                   m_settings.xMax,
+                                   m_settings.yMin,
+                                   m_settings.yMax,
+                                   getWidth(),
+                                   getHeight(),
+                                   m_settings.type,
+                                   m_minimumLevel.value_or(m_dataMinimum),
+                                   m_maximumLevel.value_or(m_dataMaximum),
+                                   m_dataVersion};
+        if (!m_image.isValid() || key != m_cacheKey)
+        {
+            render();
+            m_cacheKey = key;
+        }
+
+        g.drawImageAt(m_image, 0, 0);
+    }
+
+private:
+    void acquireThreadPool()
+    {
+        if (!m_threadPool.has_value())
+        {
+            m_threadPool.emplace();
+        }
+    }
+
+    using CacheKey = std::tuple<T, T, T, T, int, int, PlotType, T, T, std::size_t>;
+
+    static constexpr std::size_t ROWS_PER_BLOCK = 16;
+
+    void dataChanged(const std::vector<T>& z)
+    {
+        const auto [minimum, maximum] = std::minmax_element(z.begin(), z.end());
+        m_dataMinimum = *minimum;
+        m_dataMaximum = *maximum;
+
+        m_hasData = true;
+        ++m_dataVersion;
+        repaint();
+    }
+
+    void render()
+    {
+        const auto width = getWidth();
+        const auto height = getHeight();
+        if (m_image.getWidth() != width || m_image.getHeight() != height)
+        {
+            m_image = juce::Image(juce::Image::ARGB, width, height, false);
+        }
+        m_image.clear(m_image.getBounds());
+
+        // pixel centres inside the data, x grows with the column and y shrinks with the row
+        m_xValues.clear();
+        auto firstColumn = width;
+        for (int column = 0; column < width; ++column)
+        {
+            const auto x = getXValue(static_cast<T>(column) + static_cast<T>(0.5), m_settings);
+            if (x >= m_xFirst && x <= m_xLast)
+            {
+                firstColumn = std::min(firstColumn, column);
+                m_xValues.push_back(x);
+            }
+        }
+        m_yValues.clear();
+        auto firstRow = height;
+        for (int row = 0; row < height; ++row)
+        {
+            const auto y = getYValue(static_cast<T>(row) + static_cast<T>(0.5), m_settings);
+            if (y >= m_yFirst && y <= m_yLast)
+            {
+                firstRow = std::min(firstRow, row);
+                m_yValues.push_back(y);
+            }
+        }
+
+        const auto numColumns = m_xValues.size();
+        const auto numRows = m_yValues.size();
+        if (numColumns == 0 || numRows == 0)
+        {
+            return;
+        }
+        m_values.resize(numColumns * numRows);
+
+        const auto minimumLevel = m_minimumLevel.value_or(m_dataMinimum);
+        const auto maximumLevel = m_maximumLevel.value_or(m_dataMaximum);
+
+        // the spline spreads its batch over all cores itself
+        const auto scattered =
+            m_interpolation == HeatmapInterpolation::thinPlateSplineInterpolation;
+        if (scattered)
+        {
+            evaluateScattered();
+        }
+
+        juce::Image::BitmapData bitmap(m_image, juce::Image::BitmapData::writeOnly);
+        parallelFor(0,
+                    numRows,
+                    ROWS_PER_BLOCK,
+                    [&](const std::size_t blockBegin, const std::size_t blockEnd)
+                    {
+                        auto* values = m_values.data() + blockBegin * numColumns;
+                        if (!scattered)
+                        {
+                            evaluate(blockBegin, blockEnd, values);
+                        }
+
+                        for (auto row = blockBegin; row < blockEnd; ++row)
+                        {
+                            auto* pixels = reinterpret_cast<juce::PixelARGB*>(
+                                bitmap.getPixelPointer(firstColumn,
+                                                       firstRow + static_cast<int>(row)));
+                            m_colourMap->map(
+                                values + (row - blockBegin) * numColumns,
+                                numColumns,
+                                minimumLevel,
+                                maximumLevel,
+                                pixels);
+                        }
+                    });
+    }
+
+    // rows [begin, end) of the pixel grid, one row after the other
+    void evaluate(const std::size_t begin, const std::size_t end, T* values) const
+    {
+        if (m_interpolation == HeatmapInterpolation::bicubicInterpolation)
+        {
+            m_bicubic.batch_grid(m_xValues.begin(),
+                                 m_xValues.end(),
+                                 m_yValues.begin() + static_cast<long>(begin),
+                                 m_yValues.begin() + static_cast<long>(end),
+                                 values);
+        }
+        else
+        {
+            m_bilinear.batch_grid(m_xValues.begin(),
+                                  m_xValues.end(),
+                                  m_yValues.begin() + static_cast<long>(begin),
+                                  m_yValues.begin() + static_cast<long>(end),
+                                  values);
+        }
+    }
+
+    void evaluateScattered()
+    {
+        const auto numColumns = m_xValues.size();
+        m_queryX.resize(m_values.size());
+        m_queryY.resize(m_values.size());
+        for (std::size_t i = 0; i < m_values.size(); ++i)
+        {
+            m_queryX[i] = m_xValues[i % numColumns];
+            m_queryY[i] = m_yValues[i / numColumns];
+        }
+        m_thinPlateSpline.batch(
+            m_queryX.begin(), m_queryX.end(), m_queryY.begin(), m_values.begin());
+    }
+
+    const PlotSettings<T>& m_settings;
+    // acquired with the first data and held, so the pool and its threads are kept
+    // between renders, plots without data start no threads
+    std::optional<juce::SharedResourcePointer<PlotThreadPool>> m_threadPool;
+    juce::SharedResourcePointer<PlotResources> m_resources;
+    // shared with every other plot until another map is set
+    std::shared_ptr<const PlotColourMap> m_colourMap = m_resources->getDefaultColourMap();
+
+    HeatmapInterpolation m_interpolation = HeatmapInterpolation::bicubicInterpolation;
+    _2D::BilinearInterpolator<T> m_bilinear;
+    _2D::BicubicInterpolator<T> m_bicubic;
+    _2D::ThinPlateSplineInterpolator<T> m_thinPlateSpline;
+    bool m_hasData = false;
+    std::size_t m_dataVersion = 0;
+    T m_xFirst = 0, m_xLast = 1, m_yFirst = 0, m_yLast = 1;
+    T m_dataMinimum = 0, m_dataMaximum = 1;
+    std::optional<T> m_minimumLevel, m_maximumLevel;
+
+    juce::Image m_image;
+    CacheKey m_cacheKey;
+    std::vector<T> m_xValues, m_yValues, m_values;
+    std::vector<T> m_queryX, m_queryY;
+};
+} // namespace neo::plot
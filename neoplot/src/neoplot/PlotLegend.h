@@ -2,6 +2,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "PlotSettings.h"
 #include "PlotData.h"
+#include "PlotResources.h"
 
 namespace neo::plot
 {
@@ -34,7 +35,7 @@ public:
             g.setColour(m_settings.style.legendTextHovered);
             g.drawEllipse(m_circleBounds.reduced(1), 1.f);
         }
-        g.setFont(m_settings.style.legendFontSize);
+        g.setFont(m_resources->getFont(m_settings.style.legendFontSize));
         g.drawFittedText(m_data.name, m_textBounds, juce::Justification::centredRight, 1);
     }
 
@@ -72,6 +73,7 @@ public:
 private:
     const PlotSettings<T>& m_settings;
     PlotData<T>& m_data;
+    juce::SharedResourcePointer<PlotResources> m_resources;
     juce::Rectangle<float> m_circleBounds;
     juce::Rectangle<int> m_textBounds;
     bool m_hovered = false;
@@ -115,6 +117,11 @@ public:
     void dataAdded()
     {
         m_buttons.clear();
+        // plots without a legend keep no buttons
+        if (!m_settings.legend)
+        {
+            return;
+        }
         for (auto& data: m_data)
         {
             m_buttons.push_back(std::make_unique<LegendButton<T>>(m_settings, data));
@@ -133,11 +140,11 @@ public:
 
     [[nodiscard]] auto getNecessaryWidth() const -> int
     {
+        const auto font = m_resources->getFont(20.f);
         auto maxWidth = 0;
         for (const auto& data: m_data)
         {
-            const auto f = juce::Font(20.f);
-            const auto width = f.getStringWidth(data.name);
+            const auto width = font.getStringWidth(data.name);
             if (width > maxWidth)
             {
                 maxWidth = width;
@@ -151,5 +158,6 @@ private:
     const PlotSettings<T>& m_settings;
     std::vector<PlotData<T>>& m_data;
     std::vector<std::unique_ptr<LegendButton<T>>> m_buttons;
+    juce::SharedResourcePointer<PlotResources> m_resources;
 };
 } // namespace neo::plot
@@ -1,9 +1,12 @@
 #pragma once
 #include <juce_gui_basics/juce_gui_basics.h>
+#include <tuple>
 #include "PlotSettings.h"
 #include "PlotData.h"
+#include "PlotHairline.h"
 #include "PlotTools.h"
 #include "PlotMouseInteraction.h"
+#include "PlotViewModel.h"
 
 namespace neo::plot
 {
@@ -11,6 +14,7 @@ namespace neo::plot
 template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 class PlotLines : public juce::Component
+    , private juce::Timer
 {
 public:
     explicit PlotLines(const PlotSettings<T>& settings, std::vector<PlotData<T>>& data)
@@ -20,107 +24,454 @@ public:
     }
 
     void paint(juce::Graphics& g) override
+    {
+        updatePoints();
+
+        // every series has its own coverage mask at the resolution of the display,
+        // hovering, recolouring, showing or hiding a series only composites the masks
+        // again
+        const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        for (std::size_t id = 0; id < m_data.size(); ++id)
+        {
+            const auto& data = m_data[id];
+            if (!data.visible)
+            {
+                continue;
+            }
+
+            updateLayer(id, scale);
+            const auto& layer = m_layers[id];
+            if (!layer.area.isEmpty())
+            {
+                const auto origin = layer.area.getPosition().toFloat();
+                const auto toPlot = juce::AffineTransform::translation(origin.x, origin.y)
+                                        .scaled(1.f / scale, 1.f / scale);
+                g.setColour(data.clr.withAlpha(getLineAlpha(data)));
+                const auto mask = layer.mask.getClippedImage(layer.area.withZeroOrigin());
+                g.drawImageTransformed(mask, toPlot, true);
+            }
+        }
+    }
+
+    void resized() override
     {
         for (auto& data: m_data)
         {
-            if (data.visible)
+            data.prepare(static_cast<std::size_t>(m_settings.plotBounds.getWidth()));
+        }
+        m_viewOutdated = true;
+    }
+
+    // has to be called when the data changes, the points are otherwise only rebuilt when
+    // the view changes or a series without points for the view is shown
+    void dataChanged() { m_viewOutdated = true; }
+
+    // With settings.progressiveRendering the lines are drawn as a coarse preview while
+    // the view is moved: from half as many columns, each reduced from at most
+    // PREVIEW_POINTS_PER_COLUMN evenly spaced points. REFINE_DELAY_MS after the last
+    // call the full quality paths are built. Every call cancels a pending refinement.
+    void beginInteraction()
+    {
+        if (!m_settings.progressiveRendering)
+        {
+            return;
+        }
+        m_interacting = true;
+        startTimer(REFINE_DELAY_MS);
+    }
+
+    // drops a pending refinement, the preview stays until beginInteraction() is called
+    // again or the refinement is requested with refineNow()
+    void cancelRefinement() { stopTimer(); }
+
+    void refineNow()
+    {
+        stopTimer();
+        if (m_interacting)
+        {
+            m_interacting = false;
+            repaint();
+        }
+    }
+
+    [[nodiscard]] auto isShowingPreview() const -> bool { return m_interacting; }
+
+    // shares the reductions of series with shared x and y arrays with the other plots of
+    // viewModel, nullptr reduces every series here
+    void setViewModel(PlotViewModel<T>* viewModel)
+    {
+        m_viewModel = viewModel;
+        m_viewOutdated = true;
+    }
+
+private:
+    static constexpr int REFINE_DELAY_MS = 150;
+    static constexpr std::size_t PREVIEW_POINTS_PER_COLUMN = 64;
+
+    void timerCallback() override { refineNow(); }
+
+    using ViewKey = std::tuple<T, T, T, T, int, int, bool, bool, PlotType, bool, bool>;
+
+    auto getViewKey() const -> ViewKey
+    {
+        return {m_settings.xMin,
+                m_settings.xMax,
+                m_settings.yMin,
+                m_settings.yMax,
+                m_settings.plotBounds.getWidth(),
+                m_settings.plotBounds.getHeight(),
+                m_settings.yAxisInDb,
+                m_settings.fastDbConversion,
+                m_settings.type,
+                m_interacting,
+                m_settings.waveformEnvelope};
+    }
+
+    // reduces the data and builds the points of the visible series that have none for
+    // the current view. A series shown again while the view is unchanged keeps its
+    // points and its layer, so showing and hiding series does not reduce anything.
+    void updatePoints()
+    {
+        const auto viewKey = getViewKey();
+        if (m_viewOutdated || viewKey != m_viewKey)
+        {
+            m_viewOutdated = false;
+            m_viewKey = viewKey;
+            ++m_pointsVersion;
+
+            const auto width = static_cast<std::size_t>(m_settings.plotBounds.getWidth());
+            m_numColumns = m_interacting ? std::max<std::size_t>(1, width / 2) : width;
+        }
+
+        m_points.resize(m_data.size());
+        m_pointsVersions.resize(m_data.size(), 0);
+        m_pathFilled.resize(m_data.size(), false);
+        m_layers.resize(m_data.size());
+        m_pointsOutdated.assign(m_data.size(), false);
+        auto anyOutdated = false;
+        for (std::size_t id = 0; id < m_data.size(); ++id)
+        {
+            m_pointsOutdated[id] =
+                m_data[id].visible && m_pointsVersions[id] != m_pointsVersion;
+            anyOutdated = anyOutdated || m_pointsOutdated[id];
+        }
+        if (!anyOutdated)
+        {
+            return;
+        }
+
+        reduceOutdatedData();
+        for (std::size_t id = 0; id < m_data.size(); ++id)
+        {
+            if (m_pointsOutdated[id])
             {
-                if (data.hovered)
-                {
-                    g.setColour(data.clr);
-                }
-                else
-                {
-                    g.setColour(data.clr.withAlpha(0.8f));
-                }
-                juce::Path dataPath;
-                const auto numDataPoints = calculateNumDataPoints(m_settings, data);
-                if (numDataPoints > m_settings.plotBounds.getWidth())
+                buildPoints(id);
+                m_pointsVersions[id] = m_pointsVersion;
+            }
+        }
+    }
+
+    void buildPoints(const std::size_t id)
+    {
+        const auto& data = m_data[id];
+        auto& points = m_points[id];
+        points.clear();
+        m_pathFilled[id] = false;
+
+        const auto [visibleStart, visibleEnd] = m_visibleRanges[id];
+        const auto width = static_cast<std::size_t>(m_settings.plotBounds.getWidth());
+        const auto isReduced = visibleEnd - visibleStart + 1 > width;
+        if (isReduced && data.isWaveform && m_settings.waveformEnvelope)
+        {
+            addEnvelope(data, points);
+            m_pathFilled[id] = true;
+        }
+        else if (isReduced)
+        {
+            for (std::size_t i = 0; i < m_numColumns; ++i)
+            {
+                // a waveform zigzags between the minimum and maximum
+                if (data.isWaveform)
                 {
-                    transformData(m_settings, data);
-
-                    if (data.isWaveform)
-                    {
-                        startSubPath(dataPath,
-                                     m_settings,
-                                     data.xDataReduced,
-                                     data.yDataReducedWaveformMin,
-                                     0);
-                        for (std::size_t i = 0; i < data.xDataReduced.size(); ++i)
-                        {
-                            // const auto x = getXPosition(data.xDataReduced[i], m_settings);
-                            // const auto yMax =
-                            //     getYPosition(data.yDataReduced[i], m_settings);
-                            // const auto yMin =
-                            //     getYPosition(data.yDataReducedWaveformMin[i], m_settings);
-                            // g.drawVerticalLine(x, yMax, yMin);
-
-                            addToPath(dataPath,
-                                      m_settings,
-                                      data.xDataReduced,
-                                      data.yDataReducedWaveformMin,
-                                      i);
-
-                            addToPath(dataPath,
-                                      m_settings,
-                                      data.xDataReduced,
-                                      data.yDataReduced,
-                                      i);
-                        }
-                        g.strokePath(dataPath, juce::PathStrokeType(data.lineThickness));
-                    }
-                    else
-                    {
-                        startSubPath(dataPath,
-                                     m_settings,
-                                     data.xDataReduced,
-                                     data.yDataReduced,
-                                     0);
-                        for (std::size_t i = 0; i < data.xDataReduced.size(); ++i)
-                        {
-                            addToPath(dataPath,
-                                      m_settings,
-                                      data.xDataReduced,
-                                      data.yDataReduced,
-                                      i);
-                        }
-
-                        g.strokePath(dataPath, juce::PathStrokeType(data.lineThickness));
-                    }
+                    points.push_back(
+                        toPoint(data.xDataReduced[i], data.yDataReducedWaveformMin[i]));
                 }
-                else
+                points.push_back(toPoint(data.xDataReduced[i], data.yDataReduced[i]));
+            }
+        }
+        else
+        {
+            const auto& xData = data.getXData();
+            const auto& yData = data.getYData();
+            int start = static_cast<int>(visibleStart);
+            int end = static_cast<int>(visibleEnd);
+
+            start = std::clamp(start - 1, 0, int(xData.size()));
+            end = std::clamp(end + 2, 0, int(xData.size()));
+
+            for (auto i = static_cast<size_t>(start); i < static_cast<size_t>(end); ++i)
+            {
+                points.push_back(toPoint(xData[i], toDisplayValue(yData[i], m_settings)));
+            }
+        }
+    }
+
+    // series of about one pixel width are drawn by m_hairline instead of the stroker
+    static auto isHairline(const PlotData<T>& data, const float scale) -> bool
+    {
+        return !data.isWaveform && data.lineThickness * scale <= PlotHairline::MAX_WIDTH;
+    }
+
+    // masks are composited in the colour of the series with this alpha
+    static auto getLineAlpha(const PlotData<T>& data) -> float
+    {
+        return data.hovered ? data.clr.getFloatAlpha() : 0.8f;
+    }
+
+    // renders the mask of a series again when its points, its line width or the scale
+    // of the display changed
+    void updateLayer(const std::size_t id, const float scale)
+    {
+        const auto& data = m_data[id];
+        const LayerKey key {m_pointsVersions[id], scale, data.lineThickness};
+        auto& layer = m_layers[id];
+        if (key == layer.key)
+        {
+            return;
+        }
+        layer.key = key;
+
+        // only the pixels the previous line covered are cleared
+        if (!layer.area.isEmpty())
+        {
+            layer.mask.clear(layer.area.withZeroOrigin());
+        }
+        const auto& points = m_points[id];
+        layer.area = getLayerArea(points, data.lineThickness, scale);
+        if (layer.area.isEmpty())
+        {
+            return;
+        }
+
+        // the area is drawn at the top left of the mask, which only grows when the area
+        // outgrows it
+        if (!layer.mask.isValid() || layer.mask.getWidth() < layer.area.getWidth()
+            || layer.mask.getHeight() < layer.area.getHeight())
+        {
+            layer.mask = juce::Image(
+                juce::Image::SingleChannel,
+                std::max(layer.area.getWidth(), layer.mask.getWidth()),
+                std::max(layer.area.getHeight(), layer.mask.getHeight()),
+                true);
+        }
+
+        if (isHairline(data, scale))
+        {
+            m_hairline.setImage(layer.mask, scale, layer.area);
+            m_hairline.draw(points, juce::Colours::white, data.lineThickness);
+            return;
+        }
+
+        m_path.clear();
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            if (i == 0)
+                m_path.startNewSubPath(points[i]);
+            else
+                m_path.lineTo(points[i]);
+        }
+
+        juce::Graphics g(layer.mask);
+        const auto origin = layer.area.getPosition().toFloat();
+        g.addTransform(juce::AffineTransform::scale(scale, scale)
+                           .translated(-origin.x, -origin.y));
+        g.reduceClipRegion(layer.area.withZeroOrigin());
+        g.setColour(juce::Colours::white);
+        if (m_pathFilled[id])
+        {
+            m_path.closeSubPath();
+            g.fillPath(m_path);
+        }
+        else
+        {
+            g.strokePath(m_path, juce::PathStrokeType(data.lineThickness));
+        }
+    }
+
+    // the pixels of the display inside the plot a series can cover, the points widened
+    // by the longest mitre of the stroke
+    auto getLayerArea(const std::vector<juce::Point<float>>& points,
+                      const float lineThickness,
+                      const float scale) const -> juce::Rectangle<int>
+    {
+        auto left = std::numeric_limits<float>::max();
+        auto top = left;
+        auto right = std::numeric_limits<float>::lowest();
+        auto bottom = right;
+        for (const auto& point: points)
+        {
+            if (std::isfinite(point.x) && std::isfinite(point.y))
+            {
+                left = std::min(left, point.x);
+                right = std::max(right, point.x);
+                top = std::min(top, point.y);
+                bottom = std::max(bottom, point.y);
+            }
+        }
+        if (left > right)
+        {
+            return {};
+        }
+
+        const auto margin = 1.5f * lineThickness + 1.f;
+        const auto width = static_cast<float>(m_settings.plotBounds.getWidth());
+        const auto height = static_cast<float>(m_settings.plotBounds.getHeight());
+        const auto toPixel = [scale](const float value, const float size)
+        { return static_cast<int>(std::floor(std::clamp(value, 0.f, size) * scale)); };
+        const auto x = toPixel(left - margin, width);
+        const auto y = toPixel(top - margin, height);
+        const auto xEnd = toPixel(right + margin + 1.f, width);
+        const auto yEnd = toPixel(bottom + margin + 1.f, height);
+        return {x, y, xEnd - x, yEnd - y};
+    }
+
+    // outline of a reduced waveform, the maxima forward and the minima backward. It is
+    // widened by the line thickness, so it covers what the stroked zigzag covered.
+    void addEnvelope(const PlotData<T>& data, std::vector<juce::Point<float>>& points)
+    {
+        const auto halfThickness = data.lineThickness / 2.f;
+        m_envelopeLower.clear();
+        for (std::size_t i = 0; i < m_numColumns; ++i)
+        {
+            const auto maximum = toPoint(data.xDataReduced[i], data.yDataReduced[i]);
+            const auto minimum =
+                toPoint(data.xDataReduced[i], data.yDataReducedWaveformMin[i]);
+            // pixel y grows downwards
+            const auto top = std::min(maximum.y, minimum.y) - halfThickness;
+            const auto bottom = std::max(maximum.y, minimum.y) + halfThickness;
+            points.emplace_back(maximum.x, top);
+            m_envelopeLower.emplace_back(maximum.x, bottom);
+        }
+        points.insert(points.end(), m_envelopeLower.rbegin(), m_envelopeLower.rend());
+    }
+
+    // position of a value in pixels of the plot
+    auto toPoint(const T x, const T y) const -> juce::Point<float>
+    {
+        return {static_cast<float>(getXPosition(x, m_settings)),
+                static_cast<float>(getYPosition(y, m_settings))};
+    }
+
+    // finds the visible range once per x array and reduces all outdated series that
+    // share it together
+    void reduceOutdatedData()
+    {
+        const auto width = static_cast<std::size_t>(m_settings.plotBounds.getWidth());
+        m_visibleRanges.resize(m_data.size());
+        m_reduced.assign(m_data.size(), false);
+        for (std::size_t id = 0; id < m_data.size(); ++id)
+        {
+            if (!m_pointsOutdated[id] || m_reduced[id])
+            {
+                continue;
+            }
+
+            const auto& xData = m_data[id].getXData();
+            const auto range = visibleIndexRange(m_settings, xData);
+            m_group.clear();
+            for (auto other = id; other < m_data.size(); ++other)
+            {
+                if (m_pointsOutdated[other] && &m_data[other].getXData() == &xData)
                 {
-                    int start =
-                        findClosestElementIndexSorted(data.xData, m_settings.xMin);
-                    int end = findClosestElementIndexSorted(data.xData, m_settings.xMax);
-
-                    start = std::clamp(start - 1, 0, int(data.xData.size()));
-                    end = std::clamp(end + 2, 0, int(data.xData.size()));
-
-                    startSubPath(dataPath, m_settings, data.xData, data.yData, start);
-                    for (auto i = static_cast<size_t>(start);
-                         i < static_cast<size_t>(end);
-                         ++i)
-                    {
-                        addToPath(dataPath, m_settings, data.xData, data.yData, i);
-                    }
-
-                    g.strokePath(dataPath, juce::PathStrokeType(data.lineThickness));
+                    m_group.push_back(&m_data[other]);
+                    m_visibleRanges[other] = range;
+                    m_reduced[other] = true;
                 }
             }
+
+            if (range.second - range.first + 1 > width)
+            {
+                reduceGroup(range);
+            }
         }
     }
 
-    void resized() override
+    // reduces the series of m_group, series another linked plot already reduced for the
+    // same view are copied instead
+    void reduceGroup(const std::pair<std::size_t, std::size_t> range)
     {
-        for (auto& data: m_data)
+        const auto maxPointsPerColumn = m_interacting ? PREVIEW_POINTS_PER_COLUMN : 0;
+        const auto getKey = [&](const PlotData<T>& data)
+        {
+            return PlotViewModel<T>::getReductionKey(
+                m_settings, data, range, m_numColumns, maxPointsPerColumn);
+        };
+
+        if (m_viewModel != nullptr)
+        {
+            m_group.erase(std::remove_if(m_group.begin(),
+                                         m_group.end(),
+                                         [&](PlotData<T>* data)
+                                         {
+                                             return m_viewModel->copyReduction(
+                                                 *data, getKey(*data));
+                                         }),
+                          m_group.end());
+        }
+        if (m_group.empty())
+        {
+            return;
+        }
+
+        transformData(m_settings,
+                      m_group,
+                      range.first,
+                      range.second,
+                      m_numColumns,
+                      maxPointsPerColumn);
+        if (m_viewModel != nullptr)
         {
-            data.prepare(m_settings.plotBounds.getWidth());
+            for (const auto* data: m_group)
+            {
+                m_viewModel->storeReduction(*data, getKey(*data));
+            }
         }
     }
 
-private:
     const PlotSettings<T>& m_settings;
     std::vector<PlotData<T>>& m_data;
+    PlotViewModel<T>* m_viewModel = nullptr;
+    std::vector<std::pair<std::size_t, std::size_t>> m_visibleRanges;
+    std::vector<bool> m_reduced;
+    std::vector<PlotData<T>*> m_group;
+    // the visible points of every series in pixels for the view of m_pointsVersion
+    std::vector<std::vector<juce::Point<float>>> m_points;
+    std::vector<std::size_t> m_pointsVersions;
+    std::vector<bool> m_pointsOutdated;
+    // waveform envelopes are filled, all other paths stroked
+    std::vector<bool> m_pathFilled;
+    std::vector<juce::Point<float>> m_envelopeLower;
+    ViewKey m_viewKey;
+    bool m_viewOutdated = true;
+    std::size_t m_pointsVersion = 0;
+    bool m_interacting = false;
+    std::size_t m_numColumns = 0;
+
+    // version of the points, scale of the display and width of a line
+    using LayerKey = std::tuple<std::size_t, float, float>;
+
+    // the coverage of a series, one byte per pixel of the display, and the pixels its
+    // line covers, which are stored at the top left of the mask. Hidden series keep
+    // their mask, so showing them again is cheap.
+    struct Layer
+    {
+        juce::Image mask;
+        juce::Rectangle<int> area;
+        LayerKey key;
+    };
+
+    std::vector<Layer> m_layers;
+    juce::Path m_path;
+    PlotHairline m_hairline;
 };
 } // namespace neo::plot
@@ -1,4 +1,5 @@
 #pragma once
+#include "PlotPointLookup.h"
 #include "PlotTools.h"
 
 namespace neo::plot
@@ -15,6 +16,32 @@ public:
     {
     }
 
+    // the series index and the index of the point the mouse label snaps to
+    struct NearestPoint
+    {
+        std::size_t series;
+        std::size_t index;
+    };
+
+    void paint(juce::Graphics& g) override
+    {
+        if (m_drawMouseLabel && m_settings.mouseLabel && m_nearestPoint)
+        {
+            const auto& data = m_data[m_nearestPoint->series];
+            const auto x =
+                getXPosition(data.getXData()[m_nearestPoint->index], m_settings);
+            const auto y = getYPosition(
+                toDisplayValue(data.getYData()[m_nearestPoint->index], m_settings),
+                m_settings);
+            const auto radius = data.lineThickness + 2.f;
+            g.setColour(data.clr);
+            g.fillEllipse(static_cast<float>(x) - radius,
+                          static_cast<float>(y) - radius,
+                          2.f * radius,
+                          2.f * radius);
+        }
+    }
+
     void mouseMove(const juce::MouseEvent& event) override
     {
         m_mousePosition.x = event.getPosition().x;
@@ -22,44 +49,56 @@ public:
 
         if (m_settings.mouseLabel)
         {
-            getParentComponent()->repaint();
+            updateNearestPoint();
         }
+        hoverChanged();
     }
 
     void mouseEnter(const juce::MouseEvent&) override
     {
+        m_mouseOverPlot = true;
         if (m_settings.mouseLabel)
         {
             m_drawMouseLabel = true;
-            getParentComponent()->repaint();
         }
+        hoverChanged();
     }
 
     void mouseExit(const juce::MouseEvent&) override
     {
+        m_mouseOverPlot = false;
         if (m_settings.mouseLabel)
         {
             m_drawMouseLabel = false;
-            getParentComponent()->repaint();
         }
+        hoverChanged();
+    }
+
+    void mouseDown(const juce::MouseEvent&) override
+    {
+        // grabbing the plot stops it from gliding
+        m_dragging = true;
+        m_panVelocity = {};
+        m_zoomVelocity = 0;
     }
 
+    void mouseUp(const juce::MouseEvent&) override { m_dragging = false; }
+
     void mouseDrag(const juce::MouseEvent& event) override
     {
         if (m_settings.mouseInteraction)
         {
-            if (event.mods.isShiftDown())
-            {
-                moveOnXAxis(m_mousePosition.x - event.getPosition().x);
-            }
-            else
-            {
-                moveOnXAxis(m_mousePosition.x - event.getPosition().x);
-                moveOnYAxis(event.getPosition().y - m_mousePosition.y);
-            }
+            const auto dx = static_cast<T>(m_mousePosition.x - event.getPosition().x);
+            const auto dy =
+                event.mods.isShiftDown()
+                    ? static_cast<T>(0)
+                    : static_cast<T>(event.getPosition().y - m_mousePosition.y);
+            moveOnXAxis(dx);
+            moveOnYAxis(dy);
+            m_framePan += {dx, dy};
+            m_hasFrameInput = true;
 
             m_mousePosition = event.getPosition();
-            getParentComponent()->repaint();
         }
     }
 
@@ -69,8 +108,9 @@ public:
         {
             zoomXAxis(1 - scaleFactor, event.position.getX());
             zoomYAxis(1 - scaleFactor, event.position.getY());
-
-            getParentComponent()->repaint();
+            m_frameZoom += 1 - scaleFactor;
+            m_zoomCentre = event.position;
+            m_hasFrameInput = true;
         }
     }
 
@@ -92,8 +132,6 @@ public:
                 moveOnXAxis(wheel.deltaX * -300.f);
                 moveOnYAxis(wheel.deltaY * 300.f);
             }
-
-            getParentComponent()->repaint();
         }
     }
 
@@ -101,7 +139,11 @@ public:
     {
         if (m_settings.mouseInteraction)
         {
+            m_viewPending = false;
+            m_panVelocity = {};
+            m_zoomVelocity = 0;
             automaticPlotBounds(m_settings, m_data);
+            viewChanged();
             getParentComponent()->repaint();
         }
     }
@@ -113,23 +155,174 @@ public:
 
     [[nodiscard]] auto getDrawMouseLabel() const -> bool { return m_drawMouseLabel; }
 
+    [[nodiscard]] auto isMouseOverPlot() const -> bool { return m_mouseOverPlot; }
+
+    // called when the mouse moves over, enters or leaves the plot, to repaint only the
+    // layers that follow the mouse, the whole plot is repainted when it is not set
+    std::function<void()> onMouseHover;
+
+    // called once per display refresh in which the view is moved by the mouse and when it
+    // is reset by a double click, after the settings are changed and before the plot is
+    // repainted
+    std::function<void()> onViewChange;
+
+    // the visible data point closest to the mouse, if there is one
+    [[nodiscard]] auto getNearestPoint() const -> std::optional<NearestPoint>
+    {
+        return m_nearestPoint;
+    }
+
+    // drops the lookups, they are rebuilt on the next mouse move
+    void dataChanged()
+    {
+        m_lookups.clear();
+        m_nearestPoint.reset();
+    }
+
 private:
-    void moveOnXAxis(const int pixels)
+    // Input only moves a pending view, which is applied once per display refresh, so a
+    // trackpad that sends several events per frame still causes one repaint per frame.
+    // With settings.kineticInteraction the view keeps gliding after a drag or a pinch.
+    void onVBlank()
     {
-        const auto xMin = getXValue(static_cast<T>(pixels), m_settings);
-        const auto xMax = getXValue(
-            static_cast<T>(m_settings.plotBounds.getWidth() + pixels), m_settings);
-        m_settings.xMin = xMin;
-        m_settings.xMax = xMax;
+        if (m_hasFrameInput)
+        {
+            // smoothed over a few frames, the last event alone is too jittery
+            m_panVelocity = (m_panVelocity + m_framePan) * static_cast<T>(0.5);
+            m_zoomVelocity = (m_zoomVelocity + m_frameZoom) * 0.5f;
+        }
+        else if (m_settings.kineticInteraction && !m_dragging)
+        {
+            if (std::abs(m_panVelocity.x) + std::abs(m_panVelocity.y) > MIN_PAN_VELOCITY)
+            {
+                moveOnXAxis(m_panVelocity.x);
+                moveOnYAxis(m_panVelocity.y);
+                m_panVelocity *= KINETIC_DECAY;
+            }
+            if (std::abs(m_zoomVelocity) > MIN_ZOOM_VELOCITY)
+            {
+                zoomXAxis(m_zoomVelocity, m_zoomCentre.getX());
+                zoomYAxis(m_zoomVelocity, m_zoomCentre.getY());
+                m_zoomVelocity *= static_cast<float>(KINETIC_DECAY);
+            }
+        }
+        else
+        {
+            m_panVelocity = {};
+            m_zoomVelocity = 0;
+        }
+        m_framePan = {};
+        m_frameZoom = 0;
+        m_hasFrameInput = false;
+
+        if (m_viewPending)
+        {
+            applyPendingView();
+            viewChanged();
+            if (m_settings.mouseLabel)
+            {
+                updateNearestPoint();
+            }
+            getParentComponent()->repaint();
+        }
+    }
+
+    // moves the pending view to the pixels newLeft to newRight and newTop to newBottom of
+    // the pending view itself
+    void movePendingView(const T newLeft,
+                         const T newRight,
+                         const T newTop,
+                         const T newBottom)
+    {
+        const auto width = static_cast<T>(m_settings.plotBounds.getWidth());
+        const auto height = static_cast<T>(m_settings.plotBounds.getHeight());
+        if (!m_viewPending)
+        {
+            m_pendingView = {0, 0, width, height};
+            m_viewPending = true;
+        }
+
+        const auto xScale = m_pendingView.getWidth() / width;
+        const auto yScale = m_pendingView.getHeight() / height;
+        m_pendingView = {m_pendingView.getX() + newLeft * xScale,
+                         m_pendingView.getY() + newTop * yScale,
+                         (newRight - newLeft) * xScale,
+                         (newBottom - newTop) * yScale};
     }
 
-    void moveOnYAxis(const int pixels)
+    void applyPendingView()
     {
-        const auto yMin = getYValue(
-            static_cast<T>(m_settings.plotBounds.getHeight() - pixels), m_settings);
-        const auto yMax = getYValue(static_cast<T>(-pixels), m_settings);
+        const auto xMin = getXValue(m_pendingView.getX(), m_settings);
+        const auto xMax = getXValue(m_pendingView.getRight(), m_settings);
+        const auto yMin = getYValue(m_pendingView.getBottom(), m_settings);
+        const auto yMax = getYValue(m_pendingView.getY(), m_settings);
+        m_settings.xMin = xMin;
+        m_settings.xMax = xMax;
         m_settings.yMin = yMin;
         m_settings.yMax = yMax;
+        m_viewPending = false;
+    }
+
+    void viewChanged()
+    {
+        if (onViewChange)
+        {
+            onViewChange();
+        }
+    }
+
+    void hoverChanged()
+    {
+        if (onMouseHover)
+        {
+            onMouseHover();
+        }
+        else if (m_settings.mouseLabel || m_settings.crosshair)
+        {
+            getParentComponent()->repaint();
+        }
+    }
+
+    void updateNearestPoint()
+    {
+        m_lookups.resize(m_data.size());
+        m_nearestPoint.reset();
+
+        const juce::Point<T> position {static_cast<T>(m_mousePosition.x),
+                                       static_cast<T>(m_mousePosition.y)};
+        auto distance = std::numeric_limits<T>::max();
+        for (std::size_t series = 0; series < m_data.size(); ++series)
+        {
+            if (!m_data[series].visible)
+            {
+                continue;
+            }
+            if (!m_lookups[series].isBuilt())
+            {
+                m_lookups[series].build(m_data[series]);
+            }
+            // only finds a point closer than the ones of the series before
+            const auto& lookup = m_lookups[series];
+            if (const auto index =
+                    lookup.findNearest(m_data[series], m_settings, position, distance))
+            {
+                m_nearestPoint = NearestPoint {series, *index};
+            }
+        }
+    }
+
+    void moveOnXAxis(const T pixels)
+    {
+        const auto width = static_cast<T>(m_settings.plotBounds.getWidth());
+        const auto height = static_cast<T>(m_settings.plotBounds.getHeight());
+        movePendingView(pixels, width + pixels, 0, height);
+    }
+
+    void moveOnYAxis(const T pixels)
+    {
+        const auto width = static_cast<T>(m_settings.plotBounds.getWidth());
+        const auto height = static_cast<T>(m_settings.plotBounds.getHeight());
+        movePendingView(0, width, -pixels, height - pixels);
     }
 
     void zoomXAxis(const float percent, const float xPos)
@@ -144,11 +337,8 @@ private:
         const auto xMaxNew =
             static_cast<T>(m_settings.plotBounds.getWidth() + (pixels * factorXMax));
 
-        const auto xMin = getXValue(xMinNew, m_settings);
-        const auto xMax = getXValue(xMaxNew, m_settings);
-
-        m_settings.xMin = xMin;
-        m_settings.xMax = xMax;
+        movePendingView(
+            xMinNew, xMaxNew, 0, static_cast<T>(m_settings.plotBounds.getHeight()));
     }
 
     void zoomYAxis(const float percent, const float yPos)
@@ -163,16 +353,32 @@ private:
             static_cast<T>(m_settings.plotBounds.getHeight() + (pixels * factorYMin));
         const auto yMaxNew = static_cast<T>(-pixels * factorYMax);
 
-        const auto yMin = getYValue(yMinNew, m_settings);
-        const auto yMax = getYValue(yMaxNew, m_settings);
-
-        m_settings.yMin = yMin;
-        m_settings.yMax = yMax;
+        movePendingView(
+            0, static_cast<T>(m_settings.plotBounds.getWidth()), yMaxNew, yMinNew);
     }
 
     PlotSettings<T>& m_settings;
     const std::vector<PlotData<T>>& m_data;
     juce::Point<int> m_mousePosition;
     bool m_drawMouseLabel = false;
+    bool m_mouseOverPlot = false;
+    std::vector<PlotPointLookup<T>> m_lookups;
+    std::optional<NearestPoint> m_nearestPoint;
+
+    // the view input leads to, in pixels of the current view
+    juce::Rectangle<T> m_pendingView;
+    bool m_viewPending = false;
+
+    static constexpr T KINETIC_DECAY = static_cast<T>(0.92);
+    static constexpr T MIN_PAN_VELOCITY = static_cast<T>(0.2);
+    static constexpr float MIN_ZOOM_VELOCITY = 0.0005f;
+    // input of the current frame and the velocities in pixels and zoom per frame
+    juce::Point<T> m_framePan, m_panVelocity;
+    float m_frameZoom = 0, m_zoomVelocity = 0;
+    juce::Point<float> m_zoomCentre;
+    bool m_hasFrameInput = false;
+    bool m_dragging = false;
+
+    juce::VBlankAttachment m_vBlankAttachment {this, [this] { onVBlank(); }};
 };
 } // namespace neo::plot
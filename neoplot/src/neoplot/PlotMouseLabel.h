@@ -2,6 +2,7 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "PlotMouseInteraction.h"
+#include "PlotResources.h"
 #include "PlotSettings.h"
 
 namespace neo::plot
@@ -12,9 +13,11 @@ class PlotMouseLabel : public juce::Component
 {
 public:
     PlotMouseLabel(const PlotSettings<T>& settings,
-                   const PlotMouseInteraction<T>& mouseInteraction)
+                   const PlotMouseInteraction<T>& mouseInteraction,
+                   const std::vector<PlotData<T>>& data)
         : m_settings(settings)
         , m_mouseInteraction(mouseInteraction)
+        , m_data(data)
     {
     }
 
@@ -25,10 +28,18 @@ public:
             auto mouseLabelBounds = getLocalBounds();
             g.setColour(m_settings.style.mouseLabelText);
             const auto fontsize = m_settings.style.mouseLabelTextSize;
-            g.setFont(fontsize);
+            g.setFont(m_resources->getFont(fontsize));
             const auto mousePos = m_mouseInteraction.getMousePosition().toFloat();
             auto xVal = getXValue(static_cast<T>(mousePos.getX()), m_settings);
             auto yVal = getYValue(static_cast<T>(mousePos.getY()), m_settings);
+            juce::String name;
+            if (const auto point = m_mouseInteraction.getNearestPoint())
+            {
+                const auto& data = m_data[point->series];
+                xVal = data.getXData()[point->index];
+                yVal = toDisplayValue(data.getYData()[point->index], m_settings);
+                name = data.name;
+            }
             g.drawFittedText("y: " + getStringForValue(yVal, m_settings.yUnit, 2),
                              mouseLabelBounds.removeFromBottom(fontsize),
                              juce::Justification::centredLeft,
@@ -37,11 +48,19 @@ public:
                              mouseLabelBounds.removeFromBottom(fontsize),
                              juce::Justification::centredLeft,
                              1);
+            if (name.isNotEmpty())
+            {
+                const auto nameBounds =
+                    mouseLabelBounds.removeFromBottom(static_cast<int>(fontsize));
+                g.drawFittedText(name, nameBounds, juce::Justification::centredLeft, 1);
+            }
         }
     }
 
 private:
     const PlotSettings<T>& m_settings;
     const PlotMouseInteraction<T>& m_mouseInteraction;
+    const std::vector<PlotData<T>>& m_data;
+    juce::SharedResourcePointer<PlotResources> m_resources;
 };
 } // namespace neo::plot
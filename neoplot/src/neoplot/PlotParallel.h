@@ -0,0 +1,134 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "../libInterpolate/Utils/Parallel.hpp"
+
+namespace neo::plot
+{
+template <class Fn>
+void parallelFor(std::size_t begin, std::size_t end, std::size_t blockSize, Fn&& fn);
+
+// One pool of worker threads shared by all plots, hold it through a
+// juce::SharedResourcePointer so it only exists while something uses it. While it
+// exists the parallel loops of libInterpolate run on it too, instead of starting new
+// threads on every call.
+class PlotThreadPool
+{
+public:
+    PlotThreadPool()
+        : m_pool(std::max(1, juce::SystemStats::getNumCpus() - 1))
+    {
+        libInterpolate::Utils::set_executor(&runInterpolatorChunks);
+    }
+
+    ~PlotThreadPool() { libInterpolate::Utils::set_executor(nullptr); }
+
+    auto getPool() -> juce::ThreadPool& { return m_pool; }
+
+    [[nodiscard]] auto getNumThreads() const -> int { return m_pool.getNumThreads(); }
+
+private:
+    static void runInterpolatorChunks(const int numChunks,
+                                      const std::function<void(int)>& runChunk)
+    {
+        parallelFor(0,
+                    static_cast<std::size_t>(numChunks),
+                    1,
+                    [&runChunk](const std::size_t chunkBegin, const std::size_t chunkEnd)
+                    {
+                        for (auto chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+                        {
+                            runChunk(static_cast<int>(chunk));
+                        }
+                    });
+    }
+
+    juce::ThreadPool m_pool;
+};
+
+// Calls fn(blockBegin, blockEnd) for blocks of at most blockSize items covering
+// [begin, end) and returns once all of them are done. The calling thread works on
+// blocks as well and then only waits for the helpers that already started, a helper
+// the pool starts later returns without doing anything. So fn may call parallelFor()
+// itself, as the libInterpolate loops inside heatmap jobs do: a nested call never waits
+// for a job queued behind the one it runs in.
+template <class Fn>
+void parallelFor(const std::size_t begin,
+                 const std::size_t end,
+                 const std::size_t blockSize,
+                 Fn&& fn)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    const auto numBlocks = (end - begin + blockSize - 1) / blockSize;
+    if (numBlocks == 1)
+    {
+        fn(begin, end);
+        return;
+    }
+
+    juce::SharedResourcePointer<PlotThreadPool> threadPool;
+
+    std::atomic<std::size_t> nextBlock {0};
+    auto work = [&]
+    {
+        for (auto block = nextBlock++; block < numBlocks; block = nextBlock++)
+        {
+            const auto blockBegin = begin + block * blockSize;
+            fn(blockBegin, std::min(end, blockBegin + blockSize));
+        }
+    };
+
+    // a helper that only starts once the caller is done, e.g. behind other jobs of the
+    // pool, returns at once, so the caller only waits for the helpers that are running
+    struct Helpers
+    {
+        std::mutex mutex;
+        std::condition_variable done;
+        int numRunning = 0;
+        bool closed = false;
+    };
+    const auto helpers = std::make_shared<Helpers>();
+    const auto* const helperWork = &work;
+
+    const auto numHelpers = static_cast<int>(
+        std::min(numBlocks - 1, static_cast<std::size_t>(threadPool->getNumThreads())));
+    for (int i = 0; i < numHelpers; ++i)
+    {
+        threadPool->getPool().addJob(
+            [helpers, helperWork]
+            {
+                {
+                    const std::scoped_lock lock(helpers->mutex);
+                    if (helpers->closed)
+                    {
+                        return;
+                    }
+                    ++helpers->numRunning;
+                }
+
+                (*helperWork)();
+
+                const std::scoped_lock lock(helpers->mutex);
+                if (--helpers->numRunning == 0)
+                {
+                    helpers->done.notify_all();
+                }
+            });
+    }
+
+    work();
+
+    // the running helpers reference this stack frame
+    std::unique_lock lock(helpers->mutex);
+    helpers->closed = true;
+    helpers->done.wait(lock, [&helpers] { return helpers->numRunning == 0; });
+}
+} // namespace neo::plot
@@ -0,0 +1,182 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <optional>
+#include "PlotData.h"
+#include "PlotSettings.h"
+#include "PlotTools.h"
+
+namespace neo::plot
+{
+// Finds the point of a series closest to a position on screen without scanning the
+// series. The y values are summarised in a binary tree of minima and maxima over blocks
+// of LEAF_SIZE points. A query descends from the root, nearer halves first, and skips
+// every node whose x and y range on screen cannot hold a point closer than the best
+// one found so far. The x values have to be sorted.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class PlotPointLookup
+{
+public:
+    // the summary is built once, with O(n) work, and has to be rebuilt when data changes
+    void build(const PlotData<T>& data)
+    {
+        m_size = std::min(data.getXData().size(), data.getYData().size());
+        m_minimum.clear();
+        m_maximum.clear();
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        const auto numLeaves = (m_size + LEAF_SIZE - 1) / LEAF_SIZE;
+        m_minimum.emplace_back(numLeaves);
+        m_maximum.emplace_back(numLeaves);
+        for (std::size_t leaf = 0; leaf < numLeaves; ++leaf)
+        {
+            const auto* begin = data.getYData().data() + leaf * LEAF_SIZE;
+            const auto* end =
+                data.getYData().data() + std::min(m_size, (leaf + 1) * LEAF_SIZE);
+            const auto [lowest, highest] = std::minmax_element(begin, end);
+            m_minimum[0][leaf] = *lowest;
+            m_maximum[0][leaf] = *highest;
+        }
+
+        while (m_minimum.back().size() > 1)
+        {
+            const auto& lowerMinimum = m_minimum.back();
+            const auto& lowerMaximum = m_maximum.back();
+            std::vector<T> minimum((lowerMinimum.size() + 1) / 2);
+            std::vector<T> maximum(minimum.size());
+            for (std::size_t node = 0; node < minimum.size(); ++node)
+            {
+                const auto right = std::min(2 * node + 1, lowerMinimum.size() - 1);
+                minimum[node] = std::min(lowerMinimum[2 * node], lowerMinimum[right]);
+                maximum[node] = std::max(lowerMaximum[2 * node], lowerMaximum[right]);
+            }
+            m_minimum.push_back(std::move(minimum));
+            m_maximum.push_back(std::move(maximum));
+        }
+    }
+
+    [[nodiscard]] auto isBuilt() const -> bool { return !m_minimum.empty(); }
+
+    // index of the point of data closest to position, in pixels of the plot, if it is
+    // closer than distance, which is then set to its distance
+    auto findNearest(const PlotData<T>& data,
+                     const PlotSettings<T>& settings,
+                     const juce::Point<T> position,
+                     T& distance) const -> std::optional<std::size_t>
+    {
+        if (!isBuilt())
+        {
+            return std::nullopt;
+        }
+
+        Query query {
+            data.getXData(), data.getYData(), settings, position, distance * distance, {}};
+        search(query, m_minimum.size() - 1, 0);
+        if (query.best)
+        {
+            distance = std::sqrt(query.bestSquared);
+        }
+        return query.best;
+    }
+
+private:
+    static constexpr std::size_t LEAF_SIZE = 64;
+
+    struct Query
+    {
+        const std::vector<T>& xData;
+        const std::vector<T>& yData;
+        const PlotSettings<T>& settings;
+        juce::Point<T> position;
+        T bestSquared = std::numeric_limits<T>::max();
+        std::optional<std::size_t> best;
+    };
+
+    // lowest squared distance any point of the node can have
+    auto lowerBound(const Query& query,
+                    const std::size_t level,
+                    const std::size_t node) const -> T
+    {
+        const auto [begin, end] = pointRange(level, node);
+        const auto xBegin = getXPosition(query.xData[begin], query.settings);
+        const auto xEnd = getXPosition(query.xData[end - 1], query.settings);
+        const auto dx = std::max({static_cast<T>(0),
+                                  xBegin - query.position.getX(),
+                                  query.position.getX() - xEnd});
+
+        // the display and screen mappings are monotonic, the bounds stay bounds
+        const auto& settings = query.settings;
+        const auto yA =
+            getYPosition(toDisplayValue(m_minimum[level][node], settings), settings);
+        const auto yB =
+            getYPosition(toDisplayValue(m_maximum[level][node], settings), settings);
+        const auto dy = std::max({static_cast<T>(0),
+                                  std::min(yA, yB) - query.position.getY(),
+                                  query.position.getY() - std::max(yA, yB)});
+        return dx * dx + dy * dy;
+    }
+
+    auto pointRange(const std::size_t level, const std::size_t node) const
+        -> std::pair<std::size_t, std::size_t>
+    {
+        const auto pointsPerNode = LEAF_SIZE << level;
+        return {node * pointsPerNode, std::min(m_size, (node + 1) * pointsPerNode)};
+    }
+
+    void search(Query& query, const std::size_t level, const std::size_t node) const
+    {
+        if (lowerBound(query, level, node) >= query.bestSquared)
+        {
+            return;
+        }
+
+        if (level == 0)
+        {
+            const auto [begin, end] = pointRange(level, node);
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto& settings = query.settings;
+                const auto dx =
+                    getXPosition(query.xData[i], settings) - query.position.getX();
+                const auto dy =
+                    getYPosition(toDisplayValue(query.yData[i], settings), settings)
+                    - query.position.getY();
+                const auto squared = dx * dx + dy * dy;
+                if (squared < query.bestSquared)
+                {
+                    query.bestSquared = squared;
+                    query.best = i;
+                }
+            }
+            return;
+        }
+
+        const auto left = 2 * node;
+        const auto right = left + 1;
+        if (right >= m_minimum[level - 1].size())
+        {
+            search(query, level - 1, left);
+            return;
+        }
+
+        // the nearer half first, so the further one is more likely to be skipped
+        if (lowerBound(query, level - 1, right) < lowerBound(query, level - 1, left))
+        {
+            search(query, level - 1, right);
+            search(query, level - 1, left);
+        }
+        else
+        {
+            search(query, level - 1, left);
+            search(query, level - 1, right);
+        }
+    }
+
+    std::size_t m_size = 0;
+    // level 0 summarises blocks of LEAF_SIZE points, every further level pairs of nodes
+    std::vector<std::vector<T>> m_minimum, m_maximum;
+};
+} // namespace neo::plot
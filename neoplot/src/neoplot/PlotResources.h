@@ -0,0 +1,62 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "PlotColourMap.h"
+#include <BinaryData.h>
+
+namespace neo::plot
+{
+// Resources every plot draws with, shared by all plots that hold them through a
+// juce::SharedResourcePointer and released with the last one. A dashboard of hundreds of
+// plots then loads the embedded font once, and as all text is drawn with the fonts of
+// one typeface the glyphs rendered for one plot are cached for every other plot too.
+class PlotResources
+{
+public:
+    // JetBrains Mono from the binary data
+    auto getTypeface() -> juce::Typeface::Ptr
+    {
+        std::call_once(m_typefaceCreated,
+                       [this]
+                       {
+                           m_typeface = juce::Typeface::createSystemTypefaceFor(
+                               BinaryData::JetBrainsMono_ttf,
+                               BinaryData::JetBrainsMono_ttfSize);
+                       });
+        return m_typeface;
+    }
+
+    // the font of the typeface with the given height, e.g. for measuring text
+    auto getFont(const float height) -> juce::Font
+    {
+        const auto typeface = getTypeface();
+        const std::scoped_lock lock(m_fontsMutex);
+        auto it = m_fonts.find(height);
+        if (it == m_fonts.end())
+        {
+            it = m_fonts.emplace(height, juce::Font(typeface).withHeight(height)).first;
+        }
+        return it->second;
+    }
+
+    // the table of PlotColourMap::getDefaultGradient(), which spectrograms and heatmaps
+    // use until they are given another one
+    auto getDefaultColourMap() -> std::shared_ptr<const PlotColourMap>
+    {
+        std::call_once(m_colourMapCreated,
+                       [this]
+                       { m_defaultColourMap = std::make_shared<const PlotColourMap>(); });
+        return m_defaultColourMap;
+    }
+
+private:
+    std::once_flag m_typefaceCreated;
+    juce::Typeface::Ptr m_typeface;
+    std::mutex m_fontsMutex;
+    std::map<float, juce::Font> m_fonts;
+    std::once_flag m_colourMapCreated;
+    std::shared_ptr<const PlotColourMap> m_defaultColourMap;
+};
+} // namespace neo::plot
@@ -0,0 +1,684 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <atomic>
+#include <optional>
+#include <tuple>
+#include "PlotColourMap.h"
+#include "PlotParallel.h"
+#include "PlotResources.h"
+#include "PlotSettings.h"
+#include "PlotTools.h"
+
+namespace neo::plot
+{
+// Density image of unsorted points, for clouds of millions of measurements. The points
+// are counted per pixel in parallel and the logarithm of the counts is colour mapped.
+// Where a tile of the image holds only a few points they are drawn as markers instead.
+//
+// When the data is set, the points are sorted in place into the cells of a GRID_SIZE
+// square grid over their bounds, and the counts of the cells are summed up into a
+// pyramid of ever coarser grids. A view whose pixels are at least as large as a cell is
+// counted from the coarsest level with cells no larger than a pixel, the points of a cell
+// are spread over the pixels it overlaps by area. Zoomed in further, only the points of
+// the visible cells are read, which lie next to each other for every row of cells. The
+// image is kept until the view, the size or the data change.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class PlotScatter : public juce::Component
+{
+public:
+    explicit PlotScatter(const PlotSettings<T>& settings)
+        : m_settings(settings)
+    {
+        setInterceptsMouseClicks(false, false);
+    }
+
+    // x and y of every point, in any order, points that are not finite are left out.
+    // The arrays are kept sorted by cell, move them in to avoid a copy.
+    void setData(std::vector<T> x, std::vector<T> y)
+    {
+        jassert(x.size() == y.size());
+        acquireThreadPool();
+        const auto numPoints = std::min(x.size(), y.size());
+
+        m_xFirst = m_yFirst = std::numeric_limits<T>::max();
+        m_xLast = m_yLast = std::numeric_limits<T>::lowest();
+        for (std::size_t i = 0; i < numPoints; ++i)
+        {
+            if (std::isfinite(x[i]) && std::isfinite(y[i]))
+            {
+                m_xFirst = std::min(m_xFirst, x[i]);
+                m_xLast = std::max(m_xLast, x[i]);
+                m_yFirst = std::min(m_yFirst, y[i]);
+                m_yLast = std::max(m_yLast, y[i]);
+            }
+        }
+        m_hasData = m_xFirst <= m_xLast;
+        if (!m_hasData)
+        {
+            m_x.clear();
+            m_y.clear();
+            repaint();
+            return;
+        }
+        m_cellWidth = getCellSize(m_xFirst, m_xLast);
+        m_cellHeight = getCellSize(m_yFirst, m_yLast);
+
+        std::vector<std::uint32_t> cells(numPoints);
+        parallelFor(0,
+                    numPoints,
+                    POINTS_PER_BLOCK,
+                    [&](const std::size_t begin, const std::size_t end)
+                    {
+                        for (auto i = begin; i < end; ++i)
+                        {
+                            cells[i] = std::isfinite(x[i]) && std::isfinite(y[i])
+                                           ? getCellX(x[i]) + getCellY(y[i]) * GRID_SIZE
+                                           : NO_CELL;
+                        }
+                    });
+
+        // a counting sort, the points of every cell end up next to each other and the
+        // points that are not finite behind all of them
+        m_cellStart.assign(NO_CELL + 1, 0);
+        for (const auto cell: cells)
+        {
+            if (cell != NO_CELL)
+            {
+                ++m_cellStart[cell + 1];
+            }
+        }
+        std::partial_sum(m_cellStart.begin(), m_cellStart.end(), m_cellStart.begin());
+
+        // sorted in place by row and then by column within every row, so every pass only
+        // writes to a thousand places at a time
+        std::vector<std::size_t> rowStart(GRID_SIZE + 2);
+        for (std::uint32_t row = 0; row <= GRID_SIZE; ++row)
+        {
+            rowStart[row] = m_cellStart[row * GRID_SIZE];
+        }
+        rowStart.back() = numPoints;
+        std::vector<std::size_t> next;
+        sortIntoBuckets(x,
+                        y,
+                        cells,
+                        rowStart.data(),
+                        GRID_SIZE + 1,
+                        [](const std::uint32_t cell) { return cell / GRID_SIZE; },
+                        next);
+        parallelFor(0,
+                    GRID_SIZE,
+                    ROWS_PER_BLOCK,
+                    [&](const std::size_t begin, const std::size_t end)
+                    {
+                        std::vector<std::size_t> columnNext;
+                        for (auto row = begin; row < end; ++row)
+                        {
+                            sortIntoBuckets(
+                                x,
+                                y,
+                                cells,
+                                m_cellStart.data() + row * GRID_SIZE,
+                                GRID_SIZE,
+                                [](const std::uint32_t cell) { return cell % GRID_SIZE; },
+                                columnNext);
+                        }
+                    });
+        cells = {};
+
+        x.resize(m_cellStart.back());
+        y.resize(m_cellStart.back());
+        m_x = std::move(x);
+        m_y = std::move(y);
+
+        buildPyramid();
+        ++m_dataVersion;
+        repaint();
+    }
+
+    void setMarkerColour(const juce::Colour colour)
+    {
+        m_markerColour = colour;
+        repaint();
+    }
+
+    void setColourMap(const PlotColourMap& colourMap)
+    {
+        m_colourMap = std::make_shared<const PlotColourMap>(colourMap);
+        ++m_dataVersion;
+        repaint();
+    }
+
+    [[nodiscard]] auto hasData() const -> bool { return m_hasData; }
+
+    [[nodiscard]] auto getDataBounds() const -> std::tuple<T, T, T, T>
+    {
+        return {m_xFirst, m_xLast, m_yFirst, m_yLast};
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        if (!m_hasData || getWidth() <= 0 || getHeight() <= 0)
+        {
+            return;
+        }
+
+        const auto key = CacheKey {m_settings.xMin,
+                                   m_settings.xMax,
+                                   m_settings.yMin,
+                                   m_settings.yMax,
+                                   getWidth(),
+                                   getHeight(),
+                                   m_settings.type,
+                                   m_dataVersion};
+        if (!m_image.isValid() || key != m_cacheKey)
+        {
+            render();
+            m_cacheKey = key;
+        }
+
+        g.drawImageAt(m_image, 0, 0);
+        g.setColour(m_markerColour);
+        g.fillPath(m_markers);
+    }
+
+private:
+    void acquireThreadPool()
+    {
+        if (!m_threadPool.has_value())
+        {
+            m_threadPool.emplace();
+        }
+    }
+
+    using CacheKey = std::tuple<T, T, T, T, int, int, PlotType, std::size_t>;
+
+    // cells per side of the finest grid
+    static constexpr std::uint32_t GRID_SIZE = 1024;
+    // the cell of the points that are not finite, behind all cells of the grid
+    static constexpr std::uint32_t NO_CELL = GRID_SIZE * GRID_SIZE;
+    // the counts of the pixels are fixed point, as a cell is spread over several pixels
+    static constexpr std::uint64_t COUNT_SCALE = 256;
+    static constexpr std::size_t POINTS_PER_BLOCK = 1 << 16;
+    static constexpr std::size_t ROWS_PER_BLOCK = 4;
+    // square tiles of TILE_SIZE pixels with up to SPARSE_TILE_POINTS points are markers
+    static constexpr int TILE_SIZE = 16;
+    static constexpr float SPARSE_TILE_POINTS = 8.f;
+    static constexpr float MARKER_SIZE = 3.f;
+
+    // moves the points in place, so the points of every bucket follow each other. Bucket
+    // b is [starts[b], starts[b + 1]), every swap puts one point into the next free place
+    // of its bucket.
+    template <class BucketOf>
+    static void sortIntoBuckets(std::vector<T>& x,
+                                std::vector<T>& y,
+                                std::vector<std::uint32_t>& cells,
+                                const std::size_t* starts,
+                                const std::uint32_t numBuckets,
+                                BucketOf bucketOf,
+                                std::vector<std::size_t>& next)
+    {
+        next.assign(starts, starts + numBuckets);
+        for (std::uint32_t bucket = 0; bucket < numBuckets; ++bucket)
+        {
+            while (next[bucket] < starts[bucket + 1])
+            {
+                const auto i = next[bucket];
+                const auto target = bucketOf(cells[i]);
+                if (target == bucket)
+                {
+                    ++next[bucket];
+                    continue;
+                }
+                const auto j = next[target]++;
+                std::swap(x[i], x[j]);
+                std::swap(y[i], y[j]);
+                std::swap(cells[i], cells[j]);
+            }
+        }
+    }
+
+    static auto getCellSize(const T first, const T last) -> T
+    {
+        return last > first ? (last - first) / static_cast<T>(GRID_SIZE)
+                            : static_cast<T>(1);
+    }
+
+    auto getCellX(const T x) const -> std::uint32_t
+    {
+        return toCell((x - m_xFirst) / m_cellWidth);
+    }
+
+    auto getCellY(const T y) const -> std::uint32_t
+    {
+        return toCell((y - m_yFirst) / m_cellHeight);
+    }
+
+    static auto toCell(const T position) -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(
+            std::clamp(position, static_cast<T>(0), static_cast<T>(GRID_SIZE - 1)));
+    }
+
+    // level 0 holds the number of points in every cell, every further level the sums of
+    // two by two cells of the level below
+    void buildPyramid()
+    {
+        m_levels.clear();
+        m_levels.emplace_back(GRID_SIZE * GRID_SIZE);
+        for (std::size_t cell = 0; cell < m_levels[0].size(); ++cell)
+        {
+            m_levels[0][cell] =
+                static_cast<std::uint32_t>(m_cellStart[cell + 1] - m_cellStart[cell]);
+        }
+
+        for (auto size = GRID_SIZE / 2; size >= 1; size /= 2)
+        {
+            const auto& lower = m_levels.back();
+            std::vector<std::uint32_t> level(size * size);
+            for (std::uint32_t row = 0; row < size; ++row)
+            {
+                for (std::uint32_t column = 0; column < size; ++column)
+                {
+                    const auto lowerCell = 2 * row * 2 * size + 2 * column;
+                    level[row * size + column] = lower[lowerCell] + lower[lowerCell + 1]
+                                                 + lower[lowerCell + 2 * size]
+                                                 + lower[lowerCell + 2 * size + 1];
+                }
+            }
+            m_levels.push_back(std::move(level));
+        }
+    }
+
+    void render()
+    {
+        const auto width = getWidth();
+        const auto height = getHeight();
+        const auto numPixels = static_cast<std::size_t>(width * height);
+        if (m_counts.size() != numPixels)
+        {
+            m_counts = std::vector<std::atomic<std::uint64_t>>(numPixels);
+        }
+        for (auto& count: m_counts)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+
+        // the smallest pixel of the view, in values
+        const auto pixelWidth =
+            std::min(getXValue(static_cast<T>(1), m_settings)
+                         - getXValue(static_cast<T>(0), m_settings),
+                     getXValue(static_cast<T>(width), m_settings)
+                         - getXValue(static_cast<T>(width - 1), m_settings));
+        const auto pixelHeight =
+            std::min(getYValue(static_cast<T>(0), m_settings)
+                         - getYValue(static_cast<T>(1), m_settings),
+                     getYValue(static_cast<T>(height - 1), m_settings)
+                         - getYValue(static_cast<T>(height), m_settings));
+        m_countedCells = m_cellWidth <= pixelWidth && m_cellHeight <= pixelHeight;
+        if (!m_countedCells)
+        {
+            countPoints();
+        }
+        else
+        {
+            std::size_t level = 0;
+            while (level + 1 < m_levels.size()
+                   && m_cellWidth * static_cast<T>(2 << level) <= pixelWidth
+                   && m_cellHeight * static_cast<T>(2 << level) <= pixelHeight)
+            {
+                ++level;
+            }
+            countCells(level);
+        }
+
+        drawImage();
+    }
+
+    // the pixel a position falls into, if it is inside the view
+    auto getPixel(const T x, const T y) const -> std::optional<std::size_t>
+    {
+        const auto column = std::floor(getXPosition(x, m_settings));
+        const auto row = std::floor(getYPosition(y, m_settings));
+        if (!(column >= 0 && row >= 0 && column < static_cast<T>(getWidth())
+              && row < static_cast<T>(getHeight())))
+        {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>(row) * static_cast<std::size_t>(getWidth())
+               + static_cast<std::size_t>(column);
+    }
+
+    // first and last column and row of the cells of a level inside the view
+    auto getVisibleCells(const std::size_t level) const
+        -> std::tuple<std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t>
+    {
+        const auto [xMin, xMax] = std::minmax(m_settings.xMin, m_settings.xMax);
+        const auto [yMin, yMax] = std::minmax(m_settings.yMin, m_settings.yMax);
+        return {getCellX(xMin) >> level,
+                getCellX(xMax) >> level,
+                getCellY(yMin) >> level,
+                getCellY(yMax) >> level};
+    }
+
+    // counts the points of the visible cells of the finest grid one by one
+    void countPoints()
+    {
+        const auto [firstColumn, lastColumn, firstRow, lastRow] = getVisibleCells(0);
+        parallelFor(firstRow,
+                    lastRow + 1,
+                    ROWS_PER_BLOCK,
+                    [&, first = firstColumn, last = lastColumn](const std::size_t begin,
+                                                                const std::size_t end)
+                    {
+                        for (auto row = begin; row < end; ++row)
+                        {
+                            countPoints(row, first, last);
+                        }
+                    });
+    }
+
+    void countPoints(const std::size_t row,
+                     const std::uint32_t firstColumn,
+                     const std::uint32_t lastColumn)
+    {
+        // the visible cells of a row hold consecutive points
+        const auto first = m_cellStart[row * GRID_SIZE + firstColumn];
+        const auto last = m_cellStart[row * GRID_SIZE + lastColumn + 1];
+        for (auto i = first; i < last; ++i)
+        {
+            if (const auto pixel = getPixel(m_x[i], m_y[i]))
+            {
+                m_counts[*pixel].fetch_add(COUNT_SCALE, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // spreads the count of every visible cell of a pyramid level over the pixels it
+    // overlaps, in proportion to the overlapping area
+    void countCells(const std::size_t level)
+    {
+        const auto [firstColumn, lastColumn, firstRow, lastRow] = getVisibleCells(level);
+        const auto cellWidth = m_cellWidth * static_cast<T>(1 << level);
+        m_columnEdges.resize(lastColumn - firstColumn + 2);
+        for (std::size_t edge = 0; edge < m_columnEdges.size(); ++edge)
+        {
+            m_columnEdges[edge] = getXPosition(
+                m_xFirst + static_cast<T>(firstColumn + edge) * cellWidth, m_settings);
+        }
+
+        parallelFor(firstRow,
+                    lastRow + 1,
+                    ROWS_PER_BLOCK,
+                    [&, first = firstColumn, last = lastColumn](const std::size_t begin,
+                                                                const std::size_t end)
+                    {
+                        for (auto row = begin; row < end; ++row)
+                        {
+                            countCells(level, row, first, last);
+                        }
+                    });
+    }
+
+    void countCells(const std::size_t level,
+                    const std::size_t row,
+                    const std::uint32_t firstColumn,
+                    const std::uint32_t lastColumn)
+    {
+        const auto& counts = m_levels[level];
+        const auto size = GRID_SIZE >> level;
+        const auto cellHeight = m_cellHeight * static_cast<T>(1 << level);
+        const auto top =
+            getYPosition(m_yFirst + static_cast<T>(row) * cellHeight, m_settings);
+        const auto bottom =
+            getYPosition(m_yFirst + static_cast<T>(row + 1) * cellHeight, m_settings);
+        const auto [firstPixelRow, lastPixelRow] =
+            getOverlappedPixels(top, bottom, getHeight());
+
+        for (auto column = firstColumn; column <= lastColumn; ++column)
+        {
+            const auto count = counts[row * size + column];
+            if (count == 0)
+            {
+                continue;
+            }
+            const auto left = m_columnEdges[column - firstColumn];
+            const auto right = m_columnEdges[column - firstColumn + 1];
+            const auto [firstPixelColumn, lastPixelColumn] =
+                getOverlappedPixels(left, right, getWidth());
+
+            const auto scaled = static_cast<T>(count * COUNT_SCALE);
+            for (auto pixelRow = firstPixelRow; pixelRow < lastPixelRow; ++pixelRow)
+            {
+                const auto rowShare = getOverlap(top, bottom, pixelRow);
+                for (auto pixelColumn = firstPixelColumn; pixelColumn < lastPixelColumn;
+                     ++pixelColumn)
+                {
+                    const auto share =
+                        static_cast<std::uint64_t>(std::lround(
+                            scaled * rowShare * getOverlap(left, right, pixelColumn)));
+                    const auto pixel = static_cast<std::size_t>(pixelRow * getWidth())
+                                       + static_cast<std::size_t>(pixelColumn);
+                    m_counts[pixel].fetch_add(share, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    // the pixels [first, last) of a row or column of size pixels that the span between
+    // the positions a and b overlaps
+    static auto getOverlappedPixels(const T a, const T b, const int size)
+        -> std::pair<int, int>
+    {
+        const auto [lower, upper] = std::minmax(a, b);
+        const auto first = std::clamp(std::floor(lower), T(0), static_cast<T>(size));
+        const auto last = std::clamp(std::ceil(upper), T(0), static_cast<T>(size));
+        return {static_cast<int>(first), static_cast<int>(last)};
+    }
+
+    // the part of the span between the positions a and b that lies in pixel
+    static auto getOverlap(const T a, const T b, const int pixel) -> T
+    {
+        const auto [lower, upper] = std::minmax(a, b);
+        if (upper <= lower)
+        {
+            return T(1);
+        }
+        const auto start = std::max(lower, static_cast<T>(pixel));
+        const auto end = std::min(upper, static_cast<T>(pixel + 1));
+        return std::max(T(0), end - start) / (upper - lower);
+    }
+
+    // colour maps the logarithm of the counts, the pixels of sparse tiles become markers
+    void drawImage()
+    {
+        const auto width = getWidth();
+        const auto height = getHeight();
+        if (m_image.getWidth() != width || m_image.getHeight() != height)
+        {
+            m_image = juce::Image(juce::Image::ARGB, width, height, false);
+        }
+
+        m_numTileColumns = (width + TILE_SIZE - 1) / TILE_SIZE;
+        const auto numTileRows = (height + TILE_SIZE - 1) / TILE_SIZE;
+        m_tileCounts.assign(static_cast<std::size_t>(m_numTileColumns * numTileRows),
+                            0.f);
+        auto maximum = 1.f;
+        for (int row = 0; row < height; ++row)
+        {
+            for (int column = 0; column < width; ++column)
+            {
+                const auto count = getCount(column, row);
+                maximum = std::max(maximum, count);
+                m_tileCounts[getTile(column, row)] += count;
+            }
+        }
+
+        juce::Image::BitmapData bitmap(m_image, juce::Image::BitmapData::writeOnly);
+        const auto levelMaximum = std::log(maximum + 1.f);
+        parallelFor(0,
+                    static_cast<std::size_t>(height),
+                    ROWS_PER_BLOCK * TILE_SIZE,
+                    [&](const std::size_t begin, const std::size_t end)
+                    {
+                        std::vector<float> levels(static_cast<std::size_t>(width));
+                        for (auto row = begin; row < end; ++row)
+                        {
+                            drawRow(bitmap, static_cast<int>(row), levelMaximum, levels);
+                        }
+                    });
+
+        m_markers.clear();
+        if (m_countedCells)
+        {
+            addCellMarkers(numTileRows);
+            return;
+        }
+        for (int row = 0; row < height; ++row)
+        {
+            for (int column = 0; column < width; ++column)
+            {
+                if (getCount(column, row) > 0 && isSparse(column, row))
+                {
+                    addMarker(column, row);
+                }
+            }
+        }
+    }
+
+    // the counts of cells spread over several pixels, so the markers of sparse tiles are
+    // placed at the points of the cells below them instead
+    void addCellMarkers(const int numTileRows)
+    {
+        for (int tileRow = 0; tileRow < numTileRows; ++tileRow)
+        {
+            for (int tileColumn = 0; tileColumn < m_numTileColumns; ++tileColumn)
+            {
+                const auto column = tileColumn * TILE_SIZE;
+                const auto row = tileRow * TILE_SIZE;
+                if (m_tileCounts[getTile(column, row)] > 0.f && isSparse(column, row))
+                {
+                    addPointMarkers(column, row);
+                }
+            }
+        }
+    }
+
+    // markers at the pixels of the points inside the tile starting at column and row
+    void addPointMarkers(const int column, const int row)
+    {
+        const auto columnEnd = std::min(column + TILE_SIZE, getWidth());
+        const auto rowEnd = std::min(row + TILE_SIZE, getHeight());
+        const auto left = getXValue(static_cast<T>(column), m_settings);
+        const auto right = getXValue(static_cast<T>(columnEnd), m_settings);
+        const auto top = getYValue(static_cast<T>(row), m_settings);
+        const auto bottom = getYValue(static_cast<T>(rowEnd), m_settings);
+        const auto [xMin, xMax] = std::minmax(left, right);
+        const auto [yMin, yMax] = std::minmax(top, bottom);
+        const auto firstColumn = getCellX(xMin);
+        const auto lastColumn = getCellX(xMax);
+        const auto width = static_cast<std::size_t>(getWidth());
+
+        for (auto cellRow = getCellY(yMin); cellRow <= getCellY(yMax); ++cellRow)
+        {
+            const auto first = m_cellStart[cellRow * GRID_SIZE + firstColumn];
+            const auto last = m_cellStart[cellRow * GRID_SIZE + lastColumn + 1];
+            for (auto i = first; i < last; ++i)
+            {
+                const auto pixel = getPixel(m_x[i], m_y[i]);
+                if (!pixel)
+                {
+                    continue;
+                }
+                const auto pixelColumn = static_cast<int>(*pixel % width);
+                const auto pixelRow = static_cast<int>(*pixel / width);
+                if (pixelColumn >= column && pixelColumn < columnEnd && pixelRow >= row
+                    && pixelRow < rowEnd)
+                {
+                    addMarker(pixelColumn, pixelRow);
+                }
+            }
+        }
+    }
+
+    void addMarker(const int column, const int row)
+    {
+        const auto x = static_cast<float>(column) + 0.5f;
+        const auto y = static_cast<float>(row) + 0.5f;
+        m_markers.addEllipse(
+            x - MARKER_SIZE / 2, y - MARKER_SIZE / 2, MARKER_SIZE, MARKER_SIZE);
+    }
+
+    void drawRow(const juce::Image::BitmapData& bitmap,
+                 const int row,
+                 const float levelMaximum,
+                 std::vector<float>& levels) const
+    {
+        const auto width = getWidth();
+        for (int column = 0; column < width; ++column)
+        {
+            levels[static_cast<std::size_t>(column)] =
+                std::log(getCount(column, row) + 1.f);
+        }
+
+        auto* pixels = reinterpret_cast<juce::PixelARGB*>(bitmap.getLinePointer(row));
+        m_colourMap->map(levels.data(), levels.size(), 0.f, levelMaximum, pixels);
+        for (int column = 0; column < width; ++column)
+        {
+            if (getCount(column, row) <= 0.f || isSparse(column, row))
+            {
+                pixels[column] = juce::PixelARGB(0, 0, 0, 0);
+            }
+        }
+    }
+
+    auto getTile(const int column, const int row) const -> std::size_t
+    {
+        return static_cast<std::size_t>((row / TILE_SIZE) * m_numTileColumns
+                                        + column / TILE_SIZE);
+    }
+
+    auto isSparse(const int column, const int row) const -> bool
+    {
+        return m_tileCounts[getTile(column, row)] <= SPARSE_TILE_POINTS;
+    }
+
+    // number of points in a pixel, fractional where cells were spread over pixels
+    auto getCount(const int column, const int row) const -> float
+    {
+        const auto count =
+            m_counts[static_cast<std::size_t>(row * getWidth() + column)].load(
+                std::memory_order_relaxed);
+        return static_cast<float>(count) / static_cast<float>(COUNT_SCALE);
+    }
+
+    const PlotSettings<T>& m_settings;
+    // acquired with the first data and held, so the pool and its threads are kept
+    // between renders, plots without data start no threads
+    std::optional<juce::SharedResourcePointer<PlotThreadPool>> m_threadPool;
+    juce::SharedResourcePointer<PlotResources> m_resources;
+    // shared with every other plot until another map is set
+    std::shared_ptr<const PlotColourMap> m_colourMap = m_resources->getDefaultColourMap();
+    juce::Colour m_markerColour = juce::Colours::white;
+
+    bool m_hasData = false;
+    std::size_t m_dataVersion = 0;
+    T m_xFirst = 0, m_xLast = 1, m_yFirst = 0, m_yLast = 1;
+    T m_cellWidth = 1, m_cellHeight = 1;
+    // the points sorted by cell, row after row, and where the points of every cell start
+    std::vector<T> m_x, m_y;
+    std::vector<std::size_t> m_cellStart;
+    std::vector<std::vector<std::uint32_t>> m_levels;
+
+    juce::Image m_image;
+    juce::Path m_markers;
+    CacheKey m_cacheKey;
+    std::vector<std::atomic<std::uint64_t>> m_counts;
+    std::vector<float> m_tileCounts;
+    // whether the counts were spread from the cells of a pyramid level
+    bool m_countedCells = false;
+    // pixel positions of the edges of the visible columns of cells
+    std::vector<T> m_columnEdges;
+    int m_numTileColumns = 0;
+};
+} // namespace neo::plot
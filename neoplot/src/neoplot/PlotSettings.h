@@ -12,8 +12,19 @@ struct PlotSettings
     T xMin, xMax, yMin, yMax;
     PlotType type = PlotType::linear;
     bool yAxisInDb = false;
+    // dB conversion with fast_log2(), off by at most 0.001 dB
+    bool fastDbConversion = false;
     bool mouseInteraction = true;
+    // the view keeps gliding and slows down after a drag or a pinch
+    bool kineticInteraction = false;
+    // coarse lines while the view is moved, refined once it rests
+    bool progressiveRendering = false;
+    // reduced waveforms are filled between their minima and maxima instead of stroked
+    // as a zigzag, which looks the same and is much faster
+    bool waveformEnvelope = true;
     bool mouseLabel = true;
+    // vertical line at the mouse with the value of every visible series
+    bool crosshair = false;
     bool legend = true;
     bool drawZeroLines = true;
     juce::Rectangle<int> plotBounds;
@@ -68,6 +79,20 @@ struct PlotSettings
         return settings;
     }
 
+    static auto getSpectrogramPreset() -> PlotSettings<T>
+    {
+        PlotSettings<T> settings;
+        settings.type = PlotType::spectrogram;
+        settings.yAxisInDb = false;
+        settings.mouseInteraction = true;
+        settings.mouseLabel = true;
+        settings.legend = false;
+        settings.drawZeroLines = false;
+        settings.xUnit = "s";
+        settings.yUnit = "Hz";
+        return settings;
+    }
+
     static auto getTimeDbPreset() -> PlotSettings<T>
     {
         PlotSettings<T> settings;
@@ -0,0 +1,263 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace neo::plot
+{
+enum SmoothingWindow
+{
+    rectangularWindow,
+    hannWindow
+};
+
+// Fractional octave smoothing for spectra that have been warped onto a logarithmic
+// frequency axis with warp(). On the warped axis a 1/N octave window has a constant
+// length, so smoothing is a plain convolution with a precomputed kernel.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class FractionalOctaveSmoother
+{
+public:
+    // kernels up to this length are convolved directly, longer ones through the FFT
+    static constexpr int MAX_DIRECT_WINDOW_LENGTH = 64;
+
+    void smooth(const std::vector<T>& warped,
+                std::vector<T>& smoothed,
+                const int numFractions,
+                const SmoothingWindow window = SmoothingWindow::hannWindow)
+    {
+        smoothed.resize(warped.size());
+        smooth(warped.data(), smoothed.data(), warped.size(), numFractions, window);
+    }
+
+    void smooth(const T* warped,
+                T* smoothed,
+                const std::size_t numBins,
+                const int numFractions,
+                const SmoothingWindow window = SmoothingWindow::hannWindow)
+    {
+        if (numBins < 2 || numFractions <= 0)
+        {
+            std::copy(warped, warped + numBins, smoothed);
+            return;
+        }
+
+        const auto& kernel = getKernel(numBins, numFractions, window);
+
+        if (kernel.taps.size() <= 1)
+        {
+            std::copy(warped, warped + numBins, smoothed);
+        }
+        else if (window == SmoothingWindow::rectangularWindow)
+        {
+            smoothWithPrefixSums(kernel, warped, smoothed, numBins);
+        }
+        else if (kernel.taps.size() <= MAX_DIRECT_WINDOW_LENGTH)
+        {
+            smoothDirect(kernel, warped, smoothed, numBins);
+        }
+        else
+        {
+            smoothWithFFT(kernel, warped, smoothed, numBins);
+        }
+    }
+
+    // length of the smoothing window in warped bins, always odd
+    static auto getWindowLength(const std::size_t numBins, const int numFractions) -> int
+    {
+        // frequency bin spacing in octaves: log2(n_log[n] / n_log[n - 1])
+        const auto deltaN = std::log2(static_cast<double>(numBins))
+                            / static_cast<double>(numBins - 1);
+
+        // Forcing the window to have an odd length increases the deviation from the
+        // exact width, but keeps the delay of the convolution integer
+        return static_cast<int>(
+                   2. * std::floor(1. / (static_cast<double>(numFractions) * deltaN * 2.)))
+               + 1;
+    }
+
+    void clearCache() { m_kernels.clear(); }
+
+private:
+    struct Kernel
+    {
+        std::vector<T> taps;
+        // sum of the taps overlapping the data at each bin, renormalises the edges
+        std::vector<T> normalisation;
+        std::unique_ptr<juce::dsp::FFT> fft;
+        std::vector<float> spectrum;
+    };
+
+    using KernelKey = std::tuple<std::size_t, int, SmoothingWindow>;
+
+    auto getKernel(const std::size_t numBins,
+                   const int numFractions,
+                   const SmoothingWindow window) -> const Kernel&
+    {
+        const auto key = KernelKey {numBins, numFractions, window};
+        auto it = m_kernels.find(key);
+        if (it != m_kernels.end())
+        {
+            return it->second;
+        }
+
+        Kernel kernel;
+        const auto length = static_cast<std::size_t>(
+            std::min(getWindowLength(numBins, numFractions),
+                     static_cast<int>(2 * numBins - 1)));
+        kernel.taps.assign(length, static_cast<T>(1));
+
+        if (window == SmoothingWindow::hannWindow)
+        {
+            // hann window without the zero valued end points
+            for (std::size_t k = 0; k < length; ++k)
+            {
+                kernel.taps[k] = static_cast<T>(
+                    0.5
+                    - 0.5
+                          * std::cos(juce::MathConstants<double>::twoPi
+                                     * static_cast<double>(k + 1)
+                                     / static_cast<double>(length + 1)));
+            }
+        }
+
+        std::vector<double> cumulativeTaps(length + 1, 0.);
+        for (std::size_t k = 0; k < length; ++k)
+        {
+            cumulativeTaps[k + 1] = cumulativeTaps[k] + static_cast<double>(kernel.taps[k]);
+        }
+
+        const auto half = static_cast<long>(length / 2);
+        const auto lastBin = static_cast<long>(numBins) - 1;
+        kernel.normalisation.resize(numBins);
+        for (long i = 0; i <= lastBin; ++i)
+        {
+            const auto lo = std::max(0l, half - i);
+            const auto hi = std::min(static_cast<long>(length) - 1, half + lastBin - i);
+            kernel.normalisation[static_cast<std::size_t>(i)] =
+                static_cast<T>(cumulativeTaps[hi + 1] - cumulativeTaps[lo]);
+        }
+
+        if (window != SmoothingWindow::rectangularWindow
+            && length > MAX_DIRECT_WINDOW_LENGTH)
+        {
+            int order = 1;
+            while ((std::size_t {1} << order) < numBins + length - 1)
+            {
+                ++order;
+            }
+            const auto fftSize = std::size_t {1} << order;
+
+            kernel.fft = std::make_unique<juce::dsp::FFT>(order);
+            kernel.spectrum.assign(2 * fftSize, 0.f);
+            std::transform(kernel.taps.begin(),
+                           kernel.taps.end(),
+                           kernel.spectrum.begin(),
+                           [](T tap) { return static_cast<float>(tap); });
+            kernel.fft->performRealOnlyForwardTransform(kernel.spectrum.data(), true);
+        }
+
+        return m_kernels.emplace(key, std::move(kernel)).first->second;
+    }
+
+    void smoothWithPrefixSums(const Kernel& kernel,
+                              const T* warped,
+                              T* smoothed,
+                              const std::size_t numBins)
+    {
+        m_prefix.resize(numBins + 1);
+        m_prefix[0] = 0.;
+        for (std::size_t i = 0; i < numBins; ++i)
+        {
+            m_prefix[i + 1] = m_prefix[i] + static_cast<double>(warped[i]);
+        }
+
+        const auto half = kernel.taps.size() / 2;
+        for (std::size_t i = 0; i < numBins; ++i)
+        {
+            const auto lo = i > half ? i - half : 0;
+            const auto hi = std::min(numBins, i + half + 1);
+            smoothed[i] =
+                static_cast<T>((m_prefix[hi] - m_prefix[lo])
+                               / static_cast<double>(kernel.normalisation[i]));
+        }
+    }
+
+    void smoothDirect(const Kernel& kernel,
+                      const T* warped,
+                      T* smoothed,
+                      const std::size_t numBins)
+    {
+        const auto length = static_cast<long>(kernel.taps.size());
+        const auto half = length / 2;
+        const auto lastBin = static_cast<long>(numBins) - 1;
+        for (long i = 0; i <= lastBin; ++i)
+        {
+            const auto lo = std::max(0l, half - i);
+            const auto hi = std::min(length - 1, half + lastBin - i);
+            T sum = 0;
+            for (auto k = lo; k <= hi; ++k)
+            {
+                sum += kernel.taps[static_cast<std::size_t>(k)] * warped[i + k - half];
+            }
+            smoothed[i] = sum / kernel.normalisation[static_cast<std::size_t>(i)];
+        }
+    }
+
+    void smoothWithFFT(const Kernel& kernel,
+                       const T* warped,
+                       T* smoothed,
+                       const std::size_t numBins)
+    {
+        const auto fftSize = static_cast<std::size_t>(kernel.fft->getSize());
+        m_fftBuffer.resize(2 * fftSize);
+        std::transform(warped,
+                       warped + numBins,
+                       m_fftBuffer.begin(),
+                       [](T value) { return static_cast<float>(value); });
+        std::fill(m_fftBuffer.begin() + static_cast<long>(numBins), m_fftBuffer.end(), 0.f);
+
+        kernel.fft->performRealOnlyForwardTransform(m_fftBuffer.data(), true);
+
+        for (std::size_t bin = 0; bin <= fftSize / 2; ++bin)
+        {
+            const auto re = m_fftBuffer[2 * bin];
+            const auto im = m_fftBuffer[2 * bin + 1];
+            const auto kernelRe = kernel.spectrum[2 * bin];
+            const auto kernelIm = kernel.spectrum[2 * bin + 1];
+            m_fftBuffer[2 * bin] = re * kernelRe - im * kernelIm;
+            m_fftBuffer[2 * bin + 1] = re * kernelIm + im * kernelRe;
+        }
+
+        kernel.fft->performRealOnlyInverseTransform(m_fftBuffer.data());
+
+        const auto half = kernel.taps.size() / 2;
+        for (std::size_t i = 0; i < numBins; ++i)
+        {
+            smoothed[i] = static_cast<T>(m_fftBuffer[i + half]) / kernel.normalisation[i];
+        }
+    }
+
+    std::map<KernelKey, Kernel> m_kernels;
+    std::vector<double> m_prefix;
+    std::vector<float> m_fftBuffer;
+};
+
+template <typename T>
+static auto smooth_warped(const std::vector<T>& warped, int num_fractions, bool hanning = true)
+    -> std::vector<T>
+{
+    // keeps the kernels of previous calls around
+    thread_local FractionalOctaveSmoother<T> smoother;
+
+    std::vector<T> smoothed;
+    smoother.smooth(warped,
+                    smoothed,
+                    num_fractions,
+                    hanning ? SmoothingWindow::hannWindow
+                            : SmoothingWindow::rectangularWindow);
+    return smoothed;
+}
+} // namespace neo::plot
@@ -0,0 +1,208 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "PlotColourMap.h"
+#include "PlotResources.h"
+#include "PlotSettings.h"
+#include "PlotTools.h"
+
+namespace neo::plot
+{
+// Scrolling time-frequency image for PlotType::spectrogram. Every frame is reduced to
+// the image rows through a precomputed bin lookup, colour mapped once and written as
+// one column of a circular image. Painting blits the two halves of the ring with an
+// offset, so the history is never mapped or resampled again.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class PlotSpectrogram : public juce::Component
+{
+public:
+    explicit PlotSpectrogram(const PlotSettings<T>& settings)
+        : m_settings(settings)
+    {
+        setInterceptsMouseClicks(false, false);
+    }
+
+    // frequency of bin k is k * binWidth, frames arrive with framesPerSecond
+    void prepare(const std::size_t numBins,
+                 const double binWidth,
+                 const double framesPerSecond,
+                 const double historySeconds,
+                 const int numRows = 512)
+    {
+        jassert(numBins > 2);
+        m_framesPerSecond = framesPerSecond;
+        m_minFrequency = binWidth;
+        m_maxFrequency = static_cast<double>(numBins - 1) * binWidth;
+
+        const auto numColumns = std::max(
+            1, static_cast<int>(std::ceil(historySeconds * framesPerSecond)));
+        m_image = juce::Image(juce::Image::ARGB, numColumns, numRows, true);
+        m_writeColumn = 0;
+        m_numFrames = 0;
+
+        // image row 0 is the highest frequency
+        m_rowBinStart.resize(static_cast<std::size_t>(numRows));
+        m_rowBinEnd.resize(static_cast<std::size_t>(numRows));
+        const auto logMin = std::log(m_minFrequency);
+        const auto logRange = std::log(m_maxFrequency) - logMin;
+        for (int row = 0; row < numRows; ++row)
+        {
+            const auto upper = std::exp(logMin
+                                        + logRange * static_cast<double>(numRows - row)
+                                              / static_cast<double>(numRows));
+            const auto lower = std::exp(logMin
+                                        + logRange * static_cast<double>(numRows - row - 1)
+                                              / static_cast<double>(numRows));
+            const auto first = static_cast<std::size_t>(std::round(lower / binWidth));
+            const auto last = static_cast<std::size_t>(std::round(upper / binWidth));
+            m_rowBinStart[static_cast<std::size_t>(row)] = std::clamp(first, std::size_t {1}, numBins - 1);
+            m_rowBinEnd[static_cast<std::size_t>(row)] =
+                std::clamp(std::max(first, last), std::size_t {1}, numBins - 1) + 1;
+        }
+        m_rowValues.resize(static_cast<std::size_t>(numRows));
+        m_column.resize(static_cast<std::size_t>(numRows));
+
+        repaint();
+    }
+
+    // displayed level range in dB
+    void setLevelRange(const T minimumDb, const T maximumDb)
+    {
+        m_minimumDb = minimumDb;
+        m_maximumDb = maximumDb;
+    }
+
+    void setColourMap(const PlotColourMap& colourMap)
+    {
+        m_colourMap = std::make_shared<const PlotColourMap>(colourMap);
+    }
+
+    // linear magnitudes of numBins bins, only the new column is mapped and written
+    void addFrame(const T* magnitudes)
+    {
+        if (!m_image.isValid())
+        {
+            return;
+        }
+
+        for (std::size_t row = 0; row < m_rowValues.size(); ++row)
+        {
+            m_rowValues[row] = *std::max_element(magnitudes + m_rowBinStart[row],
+                                                 magnitudes + m_rowBinEnd[row]);
+        }
+        lin_to_db(m_rowValues.data(),
+                  m_rowValues.data(),
+                  m_rowValues.size(),
+                  m_settings.fastDbConversion);
+        m_colourMap->map(m_rowValues.data(),
+                         m_rowValues.size(),
+                         m_minimumDb,
+                         m_maximumDb,
+                         m_column.data());
+
+        juce::Image::BitmapData bitmap(m_image,
+                                       m_writeColumn,
+                                       0,
+                                       1,
+                                       m_image.getHeight(),
+                                       juce::Image::BitmapData::writeOnly);
+        for (int row = 0; row < m_image.getHeight(); ++row)
+        {
+            *reinterpret_cast<juce::PixelARGB*>(bitmap.getPixelPointer(0, row)) =
+                m_column[static_cast<std::size_t>(row)];
+        }
+
+        m_writeColumn = (m_writeColumn + 1) % m_image.getWidth();
+        ++m_numFrames;
+        repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        if (!m_image.isValid() || m_numFrames == 0)
+        {
+            return;
+        }
+
+        g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+
+        // columns [0, writeColumn) hold the newest frames, the newest one ends at time 0
+        drawSegment(g, 0, m_writeColumn, static_cast<double>(m_writeColumn));
+
+        // columns [writeColumn, width) are one turn of the ring older
+        if (m_numFrames > static_cast<std::size_t>(m_writeColumn))
+        {
+            drawSegment(g,
+                        m_writeColumn,
+                        m_image.getWidth(),
+                        static_cast<double>(m_writeColumn + m_image.getWidth()));
+        }
+    }
+
+    [[nodiscard]] auto getHistorySeconds() const -> double
+    {
+        return static_cast<double>(m_image.getWidth()) / m_framesPerSecond;
+    }
+
+    [[nodiscard]] auto getMinFrequency() const -> double { return m_minFrequency; }
+
+    [[nodiscard]] auto getMaxFrequency() const -> double { return m_maxFrequency; }
+
+private:
+    // draws image columns [start, end), column c covers the time (c - offset) / fps
+    void drawSegment(juce::Graphics& g, const int start, const int end, const double offset)
+    {
+        if (end <= start)
+        {
+            return;
+        }
+
+        const auto width = static_cast<double>(m_settings.plotBounds.getWidth());
+        const auto height = static_cast<double>(m_settings.plotBounds.getHeight());
+        const auto xMin = static_cast<double>(m_settings.xMin);
+        const auto xMax = static_cast<double>(m_settings.xMax);
+
+        // x = ((u + start - offset) / fps - xMin) * width / (xMax - xMin)
+        const auto scaleX = width / ((xMax - xMin) * m_framesPerSecond);
+        const auto translateX =
+            (static_cast<double>(start) - offset) * scaleX - xMin * width / (xMax - xMin);
+
+        // row v sits at log f = log fMax - v / rows * (log fMax - log fMin)
+        const auto logYMin = std::log(static_cast<double>(m_settings.yMin));
+        const auto logYRange = std::log(static_cast<double>(m_settings.yMax)) - logYMin;
+        const auto logMax = std::log(m_maxFrequency);
+        const auto logRange = logMax - std::log(m_minFrequency);
+        const auto scaleY = height * logRange
+                            / (static_cast<double>(m_image.getHeight()) * logYRange);
+        const auto translateY = height * (1. - (logMax - logYMin) / logYRange);
+
+        const juce::AffineTransform transform(static_cast<float>(scaleX),
+                                              0.f,
+                                              static_cast<float>(translateX),
+                                              0.f,
+                                              static_cast<float>(scaleY),
+                                              static_cast<float>(translateY));
+
+        g.drawImageTransformed(
+            m_image.getClippedImage({start, 0, end - start, m_image.getHeight()}),
+            transform);
+    }
+
+    const PlotSettings<T>& m_settings;
+    juce::SharedResourcePointer<PlotResources> m_resources;
+    // shared with every other plot until another map is set
+    std::shared_ptr<const PlotColourMap> m_colourMap = m_resources->getDefaultColourMap();
+
+    juce::Image m_image;
+    int m_writeColumn = 0;
+    std::size_t m_numFrames = 0;
+
+    double m_framesPerSecond = 60.;
+    double m_minFrequency = 1., m_maxFrequency = 2.;
+    T m_minimumDb = static_cast<T>(MINUS_INF), m_maximumDb = static_cast<T>(0);
+
+    std::vector<std::size_t> m_rowBinStart, m_rowBinEnd;
+    std::vector<T> m_rowValues;
+    std::vector<juce::PixelARGB> m_column;
+};
+} // namespace neo::plot
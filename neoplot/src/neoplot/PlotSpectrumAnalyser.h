@@ -0,0 +1,245 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include "NeoPlot.h"
+#include "PlotSmoothing.h"
+
+namespace neo::plot
+{
+// Live spectrum of an audio stream shown as one frequency series of a NeoPlot.
+// pushSamples() is meant for the audio thread, everything else runs on the message
+// thread once per display refresh. All buffers are allocated up front and the series
+// is updated in place with linear magnitudes, the plot maps them to dB for display.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class PlotSpectrumAnalyser
+{
+public:
+    PlotSpectrumAnalyser(NeoPlot<T>& plot,
+                         const int fftOrder,
+                         const double sampleRate,
+                         juce::Colour clr = juce::Colours::white,
+                         const juce::String& name = "Spectrum")
+        : m_plot(plot)
+        , m_fft(fftOrder)
+        , m_fftSize(static_cast<std::size_t>(1) << fftOrder)
+        , m_numBins(m_fftSize / 2)
+        , m_fifo(static_cast<int>(FIFO_FRAMES * m_fftSize))
+        , m_fifoBuffer(FIFO_FRAMES * m_fftSize)
+        , m_history(m_fftSize, 0.f)
+        , m_window(m_fftSize)
+        , m_fftData(2 * m_fftSize)
+        , m_magnitude(m_numBins)
+        , m_warped(m_numBins)
+        , m_warpIndex(m_numBins)
+        , m_warpFraction(m_numBins)
+    {
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(
+            m_window.data(),
+            m_fftSize,
+            juce::dsp::WindowingFunction<float>::hann,
+            false);
+        const auto windowSum = std::accumulate(m_window.begin(), m_window.end(), 0.);
+        // a full scale sine ends up at 1
+        m_magnitudeScale = static_cast<T>(2. / windowSum);
+
+        // the same log spacing as warp(), as fractional bin positions starting at 1
+        const auto N = static_cast<double>(m_numBins);
+        for (std::size_t k = 0; k < m_numBins; ++k)
+        {
+            const auto position =
+                std::pow(N, static_cast<double>(k) / (N - 1.)) - 1.;
+            const auto index =
+                std::min(static_cast<std::size_t>(position), m_numBins - 2);
+            m_warpIndex[k] = index;
+            m_warpFraction[k] = static_cast<T>(position - static_cast<double>(index));
+        }
+
+        PlotData<T> data(0, clr);
+        data.name = name;
+        data.isAlreadyWarped = true;
+        data.xData.resize(m_numBins);
+        data.yData.assign(m_numBins, static_cast<T>(0));
+        m_plot.addData(data, false);
+        m_dataId = m_plot.getNumData() - 1;
+
+        setSampleRate(sampleRate);
+    }
+
+    void setSampleRate(const double sampleRate)
+    {
+        auto& xData = m_plot.getData(m_dataId).xData;
+        const auto binWidth = sampleRate / static_cast<double>(m_fftSize);
+        for (std::size_t k = 0; k < m_numBins; ++k)
+        {
+            xData[k] = static_cast<T>(
+                (static_cast<double>(m_warpIndex[k]) + 1.
+                 + static_cast<double>(m_warpFraction[k]))
+                * binWidth);
+        }
+        m_plot.dataUpdated();
+    }
+
+    // 1/N octave smoothing of the warped spectrum, 0 turns it off
+    void setSmoothing(const int numFractions,
+                      const SmoothingWindow window = SmoothingWindow::hannWindow)
+    {
+        m_smoothingFractions = numFractions;
+        m_smoothingWindow = window;
+    }
+
+    // spectra are never computed faster than this, nor faster than the display
+    void setMaxFrameRate(const double framesPerSecond)
+    {
+        m_minFrameInterval = framesPerSecond > 0. ? 1000. / framesPerSecond : 0.;
+    }
+
+    // frames that were dropped because the plot had not painted the previous one yet
+    [[nodiscard]] auto getNumSkippedFrames() const -> std::size_t
+    {
+        return m_numSkippedFrames;
+    }
+
+    // realtime safe, if the message thread falls behind the newest samples are dropped
+    void pushSamples(const float* samples, const int numSamples)
+    {
+        int start1, size1, start2, size2;
+        m_fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        std::copy(samples, samples + size1, m_fifoBuffer.data() + start1);
+        std::copy(samples + size1, samples + size1 + size2, m_fifoBuffer.data() + start2);
+        m_fifo.finishedWrite(size1 + size2);
+    }
+
+private:
+    void processFrame()
+    {
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+        if (now - m_lastFrameTime < m_minFrameInterval)
+        {
+            return;
+        }
+
+        if (!readFromFifo())
+        {
+            return;
+        }
+
+        if (m_plot.getNumPaintedFrames() == m_paintedFramesAtLastUpdate)
+        {
+            ++m_numSkippedFrames;
+            return;
+        }
+
+        m_lastFrameTime = now;
+
+        // oldest sample first
+        const auto tail = m_fftSize - m_historyPosition;
+        std::copy(m_history.begin() + static_cast<long>(m_historyPosition),
+                  m_history.end(),
+                  m_fftData.begin());
+        std::copy(m_history.begin(),
+                  m_history.begin() + static_cast<long>(m_historyPosition),
+                  m_fftData.begin() + static_cast<long>(tail));
+        juce::FloatVectorOperations::multiply(
+            m_fftData.data(), m_window.data(), static_cast<int>(m_fftSize));
+
+        m_fft.performFrequencyOnlyForwardTransform(m_fftData.data(), true);
+
+        // skip the DC bin, like warp() the spectrum starts at bin 1
+        for (std::size_t k = 0; k < m_numBins; ++k)
+        {
+            m_magnitude[k] = static_cast<T>(m_fftData[k + 1]) * m_magnitudeScale;
+        }
+
+        auto& yData = m_plot.getData(m_dataId).yData;
+        const auto smoothing = m_smoothingFractions > 0;
+        auto& warped = smoothing ? m_warped : yData;
+        for (std::size_t k = 0; k < m_numBins; ++k)
+        {
+            const auto index = m_warpIndex[k];
+            warped[k] = m_magnitude[index]
+                        + m_warpFraction[k] * (m_magnitude[index + 1] - m_magnitude[index]);
+        }
+
+        if (smoothing)
+        {
+            m_smoother.smooth(m_warped.data(),
+                              yData.data(),
+                              m_numBins,
+                              m_smoothingFractions,
+                              m_smoothingWindow);
+        }
+
+        m_paintedFramesAtLastUpdate = m_plot.getNumPaintedFrames();
+        m_plot.dataUpdated();
+    }
+
+    // moves everything from the fifo into the history, returns false without new samples
+    auto readFromFifo() -> bool
+    {
+        const auto numReady = m_fifo.getNumReady();
+        if (numReady == 0)
+        {
+            return false;
+        }
+
+        int start1, size1, start2, size2;
+        m_fifo.prepareToRead(numReady, start1, size1, start2, size2);
+        appendToHistory(m_fifoBuffer.data() + start1, static_cast<std::size_t>(size1));
+        appendToHistory(m_fifoBuffer.data() + start2, static_cast<std::size_t>(size2));
+        m_fifo.finishedRead(size1 + size2);
+        return true;
+    }
+
+    void appendToHistory(const float* samples, std::size_t numSamples)
+    {
+        // only the newest fftSize samples can end up in the spectrum
+        if (numSamples > m_fftSize)
+        {
+            samples += numSamples - m_fftSize;
+            numSamples = m_fftSize;
+        }
+
+        while (numSamples > 0)
+        {
+            const auto chunk = std::min(numSamples, m_fftSize - m_historyPosition);
+            std::copy(samples,
+                      samples + chunk,
+                      m_history.begin() + static_cast<long>(m_historyPosition));
+            m_historyPosition = (m_historyPosition + chunk) % m_fftSize;
+            samples += chunk;
+            numSamples -= chunk;
+        }
+    }
+
+    static constexpr std::size_t FIFO_FRAMES = 4;
+
+    NeoPlot<T>& m_plot;
+    std::size_t m_dataId = 0;
+
+    juce::dsp::FFT m_fft;
+    const std::size_t m_fftSize, m_numBins;
+
+    juce::AbstractFifo m_fifo;
+    std::vector<float> m_fifoBuffer;
+    std::vector<float> m_history;
+    std::size_t m_historyPosition = 0;
+
+    std::vector<float> m_window;
+    std::vector<float> m_fftData;
+    T m_magnitudeScale = 1;
+    std::vector<T> m_magnitude, m_warped;
+    std::vector<std::size_t> m_warpIndex;
+    std::vector<T> m_warpFraction;
+
+    FractionalOctaveSmoother<T> m_smoother;
+    int m_smoothingFractions = 0;
+    SmoothingWindow m_smoothingWindow = SmoothingWindow::hannWindow;
+
+    double m_minFrameInterval = 0.;
+    double m_lastFrameTime = 0.;
+    std::size_t m_paintedFramesAtLastUpdate = std::numeric_limits<std::size_t>::max();
+    std::size_t m_numSkippedFrames = 0;
+
+    juce::VBlankAttachment m_vBlankAttachment {&m_plot, [this] { processFrame(); }};
+};
+} // namespace neo::plot
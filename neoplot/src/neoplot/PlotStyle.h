@@ -19,6 +19,9 @@ struct PlotStyle
     // MOUSE LABEL
     juce::Colour mouseLabelText = juce::Colours::white;
     float mouseLabelTextSize = 15.f;
+    // CROSSHAIR
+    juce::Colour crosshair = juce::Colours::white.withAlpha(0.5f);
+    juce::Colour crosshairBackground = juce::Colours::black.withAlpha(0.6f);
     // AXIS LABEL
     juce::Colour axisLabelText = juce::Colours::white;
     float axisLabelFontSize = 15.f;
@@ -2,6 +2,8 @@
 #include <Eigen/Eigen>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include "PlotSettings.h"
 #include "PlotData.h"
 #include "PlotType.h"
@@ -11,30 +13,94 @@
 namespace neo::plot
 {
 constexpr double MINUS_INF = -100.;
+// linear value of MINUS_INF, 10^(MINUS_INF / 20)
+constexpr double MINUS_INF_LINEAR = 1e-5;
+
+// log2(x) to within 1.2e-4 for positive normal floats, which is better than 0.001 dB.
+// The mantissa is approximated by a degree 4 minimax polynomial that is exact at both
+// ends of the octave, so the result stays continuous and monotonic across octaves.
+inline auto fast_log2(const float x) -> float
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(float));
+    const auto exponent = static_cast<float>(static_cast<int>(bits >> 23) - 127);
+    bits = (bits & 0x007fffffu) | 0x3f800000u;
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(float));
+    const auto t = mantissa - 1.f;
+    return exponent
+           + t
+                 * (1.4387257428f
+                    + t * (-0.6777839886f + t * (0.3211889473f + t * -0.0821307015f)));
+}
+
+template <typename T>
+static inline auto lin_to_db(T lin) -> T
+{
+    if (lin <= static_cast<T>(MINUS_INF_LINEAR))
+        return static_cast<T>(MINUS_INF);
+    return static_cast<T>(20. * std::log10(static_cast<double>(lin)));
+}
+
+// converts a whole block, values at or below MINUS_INF_LINEAR end up at MINUS_INF,
+// lin and db may point to the same memory
+template <typename T>
+static inline void lin_to_db(const T* lin, T* db, const std::size_t size, bool fast = false)
+{
+    static_assert(std::is_floating_point<T>::value);
+    if (fast)
+    {
+        // 20 * log10(x) = 20 * log10(2) * log2(x)
+        constexpr auto dbPerOctave = static_cast<float>(6.0205999132796239);
+        constexpr auto minimum = static_cast<T>(MINUS_INF_LINEAR);
+        constexpr auto maximum = static_cast<T>(std::numeric_limits<float>::max());
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            auto value = lin[i] < minimum ? minimum : lin[i];
+            value = value > maximum ? maximum : value;
+            db[i] = static_cast<T>(dbPerOctave * fast_log2(static_cast<float>(value)));
+        }
+    }
+    else
+    {
+        Eigen::Map<const Eigen::ArrayX<T>> in(lin, static_cast<long>(size));
+        Eigen::Map<Eigen::ArrayX<T>> out(db, static_cast<long>(size));
+        out = in.max(static_cast<T>(MINUS_INF_LINEAR)).log10() * static_cast<T>(20);
+    }
+}
+
+template <typename T>
+static inline void lin_to_db(std::vector<T>& lin, bool fast = false)
+{
+    lin_to_db(lin.data(), lin.data(), lin.size(), fast);
+}
 
 template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 auto findClosestElementIndexSorted(const std::vector<T>& data, const T element)
     -> std::size_t
 {
-    auto it = std::min_element(data.begin(),
-                               data.end(),
-                               [element](T a, T b)
-                               { return std::abs(element - a) < std::abs(element - b); });
-
-    auto index = std::distance(data.begin(), it);
-
-    return index;
+    // binary search for the first element not below element, the closest one is either
+    // that or the one before, on a tie the first of them
+    const auto it = std::lower_bound(data.begin(), data.end(), element);
+    if (it == data.begin())
+    {
+        return 0;
+    }
+    const auto before = std::prev(it);
+    if (it == data.end() || std::abs(element - *before) <= std::abs(element - *it))
+    {
+        return static_cast<std::size_t>(
+            std::distance(data.begin(), std::lower_bound(data.begin(), it, *before)));
+    }
+    return static_cast<std::size_t>(std::distance(data.begin(), it));
 }
 
 template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 auto findClosestElementSorted(const std::vector<T>& data, const T element) -> T
 {
-    return *std::min_element(data.begin(),
-                             data.end(),
-                             [element](T a, T b)
-                             { return std::abs(element - a) < std::abs(element - b); });
+    return data[findClosestElementIndexSorted(data, element)];
 }
 
 template <class T,
@@ -57,7 +123,7 @@ template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 inline auto getXPosition(const T value, const PlotSettings<T>& settings) -> T
 {
-    if (settings.type == PlotType::linear)
+    if (settings.type != PlotType::logarithmic)
     {
         return juce::jmap(value,
                           settings.xMin,
@@ -77,6 +143,12 @@ template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 inline auto getYPosition(const T value, const PlotSettings<T>& settings) -> T
 {
+    if (settings.type == PlotType::spectrogram)
+    {
+        return juce::jmap(juce::mapFromLog10(value + static_cast<T>(10e-40), settings.yMin, settings.yMax),
+                          static_cast<T>(settings.plotBounds.getHeight()),
+                          static_cast<T>(0));
+    }
     return juce::jmap(value,
                       settings.yMin,
                       settings.yMax,
@@ -88,7 +160,7 @@ template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 inline auto getXValue(const T position, const PlotSettings<T>& settings) -> T
 {
-    if (settings.type == PlotType::linear)
+    if (settings.type != PlotType::logarithmic)
     {
         return juce::jmap(position,
                           static_cast<T>(0),
@@ -112,6 +184,16 @@ template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 inline auto getYValue(const T position, const PlotSettings<T>& settings) -> T
 {
+    if (settings.type == PlotType::spectrogram)
+    {
+        return juce::mapToLog10(juce::jmap(position,
+                                           static_cast<T>(settings.plotBounds.getHeight()),
+                                           static_cast<T>(0),
+                                           static_cast<T>(0),
+                                           static_cast<T>(1)),
+                                settings.yMin,
+                                settings.yMax);
+    }
     return juce::jmap(position,
                       static_cast<T>(settings.plotBounds.getHeight()),
                       static_cast<T>(0),
@@ -119,6 +201,20 @@ inline auto getYValue(const T position, const PlotSettings<T>& settings) -> T
                       settings.yMax);
 }
 
+// series keep linear values, the dB mapping is applied to what reaches the screen
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+inline auto toDisplayValue(const T value, const PlotSettings<T>& settings) -> T
+{
+    if (!settings.yAxisInDb)
+    {
+        return value;
+    }
+    T db;
+    lin_to_db(&value, &db, 1, settings.fastDbConversion);
+    return db;
+}
+
 template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 inline void addToPath(juce::Path& path,
@@ -145,13 +241,21 @@ inline void startSubPath(juce::Path& path,
     path.startNewSubPath(x, y);
 }
 
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+inline auto visibleIndexRange(const PlotSettings<T>& settings, const std::vector<T>& xData)
+    -> std::pair<std::size_t, std::size_t>
+{
+    return {findClosestElementIndexSorted(xData, settings.xMin),
+            findClosestElementIndexSorted(xData, settings.xMax)};
+}
+
 template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 inline auto calculateNumDataPoints(const PlotSettings<T>& settings,
                                    const PlotData<T>& inData) -> std::size_t
 {
-    const auto start = findClosestElementIndexSorted(inData.xData, settings.xMin);
-    const auto end = findClosestElementIndexSorted(inData.xData, settings.xMax);
+    const auto [start, end] = visibleIndexRange(settings, inData.getXData());
     return end - start + 1;
 }
 
@@ -178,27 +282,42 @@ auto getStringForValue(const T value,
     }
 }
 
+// reduces series that share their x values, e.g. the channels of one recording, to
+// numColumns points between the indices start and end. The x values of a column are
+// averaged once, its y values are then reduced for all series in the same sweep. A
+// maxPointsPerColumn above 0 reads only every n-th point of wider columns, for a fast
+// preview of very large series.
 template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
-void transformData(const PlotSettings<T>& settings, PlotData<T>& data)
+void transformData(const PlotSettings<T>& settings,
+                   const std::vector<PlotData<T>*>& series,
+                   const std::size_t start,
+                   const std::size_t end,
+                   const std::size_t numColumns,
+                   const std::size_t maxPointsPerColumn = 0)
 {
-    assert(data.xDataReduced.size() >= settings.plotBounds.getWidth());
-    assert(data.yDataReduced.size() >= settings.plotBounds.getWidth());
+    const auto& xData = series.front()->getXData();
+    for (const auto* data: series)
+    {
+        assert(&data->getXData() == &xData);
+        assert(data->xDataReduced.size() >= numColumns);
+        assert(data->yDataReduced.size() >= numColumns);
+    }
 
-    const auto start = findClosestElementIndexSorted(data.xData, settings.xMin);
-    const auto end = findClosestElementIndexSorted(data.xData, settings.xMax);
     const auto numDataPoints = end - start + 1;
 
-    if (numDataPoints > settings.plotBounds.getWidth())
+    if (numDataPoints > numColumns)
     {
+        using StridedMap =
+            Eigen::Map<const Eigen::ArrayX<T>, Eigen::Unaligned, Eigen::InnerStride<>>;
+
         // reducer
-        const T window = static_cast<T>(numDataPoints)
-                         / static_cast<T>(settings.plotBounds.getWidth());
+        const T window = static_cast<T>(numDataPoints) / static_cast<T>(numColumns);
         const T remainder = window - static_cast<int>(window);
         T running_remainder = remainder;
         std::size_t windowToUse;
         std::size_t moving_start = start;
-        for (size_t i = 0; i < settings.plotBounds.getWidth(); i++)
+        for (size_t i = 0; i < numColumns; i++)
         {
             if (static_cast<float>(running_remainder) < 1.f)
             {
@@ -210,38 +329,80 @@ void transformData(const PlotSettings<T>& settings, PlotData<T>& data)
                 running_remainder -= 1.f;
             }
 
-            data.xDataReduced[i] =
-                Eigen::Map<Eigen::ArrayX<T>>(data.xData.data(),
-                                             static_cast<long>(data.xData.size()))
-                    .segment(moving_start, windowToUse)
-                    .mean();
-
-            if (data.isWaveform)
+            // reads the column of values through the window, x once and y of every series
+            const auto reduceColumn = [&](const auto& readColumn)
+            {
+                const T xMean = readColumn(xData).mean();
+
+                for (auto* data: series)
+                {
+                    data->xDataReduced[i] = xMean;
+
+                    const auto y = readColumn(data->getYData());
+
+                    if (data->isWaveform)
+                    {
+                        data->yDataReduced[i] = y.maxCoeff();
+                        data->yDataReducedWaveformMin[i] = y.minCoeff();
+                    }
+                    else if (settings.yAxisInDb)
+                    {
+                        // the maximum commutes with the dB mapping, the mean does not
+                        data->yDataReduced[i] = y.maxCoeff();
+                    }
+                    else
+                    {
+                        data->yDataReduced[i] = y.mean();
+                    }
+                }
+            };
+
+            const auto stride =
+                maxPointsPerColumn == 0
+                    ? std::size_t {1}
+                    : std::max<std::size_t>(1, windowToUse / maxPointsPerColumn);
+            if (stride == 1)
             {
-                data.yDataReduced[i] =
-                    Eigen::Map<Eigen::ArrayX<T>>(data.yData.data(),
-                                                 static_cast<long>(data.yData.size()))
-                        .segment(moving_start, windowToUse)
-                        .maxCoeff();
-
-                data.yDataReducedWaveformMin[i] =
-                    Eigen::Map<Eigen::ArrayX<T>>(data.yData.data(),
-                                                 static_cast<long>(data.yData.size()))
-                        .segment(moving_start, windowToUse)
-                        .minCoeff();
+                // contiguous, so Eigen can vectorise the reductions
+                reduceColumn(
+                    [&](const std::vector<T>& values)
+                    {
+                        return Eigen::Map<const Eigen::ArrayX<T>>(
+                            values.data() + moving_start, static_cast<long>(windowToUse));
+                    });
             }
             else
             {
-                data.yDataReduced[i] =
-                    Eigen::Map<Eigen::ArrayX<T>>(data.yData.data(),
-                                                 static_cast<long>(data.yData.size()))
-                        .segment(moving_start, windowToUse)
-                        .mean();
+                const auto count = static_cast<long>((windowToUse + stride - 1) / stride);
+                const Eigen::InnerStride<> innerStride(static_cast<long>(stride));
+                reduceColumn(
+                    [&](const std::vector<T>& values)
+                    {
+                        return StridedMap(values.data() + moving_start, count, innerStride);
+                    });
             }
 
             moving_start += windowToUse;
             running_remainder += remainder;
         }
+
+        if (settings.yAxisInDb)
+        {
+            for (auto* data: series)
+            {
+                lin_to_db(data->yDataReduced.data(),
+                          data->yDataReduced.data(),
+                          numColumns,
+                          settings.fastDbConversion);
+                if (data->isWaveform)
+                {
+                    lin_to_db(data->yDataReducedWaveformMin.data(),
+                              data->yDataReducedWaveformMin.data(),
+                              numColumns,
+                              settings.fastDbConversion);
+                }
+            }
+        }
     }
     else
     {
@@ -249,6 +410,18 @@ void transformData(const PlotSettings<T>& settings, PlotData<T>& data)
     }
 }
 
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+void transformData(const PlotSettings<T>& settings, PlotData<T>& data)
+{
+    const auto [start, end] = visibleIndexRange(settings, data.getXData());
+    transformData(settings,
+                  std::vector<PlotData<T>*> {&data},
+                  start,
+                  end,
+                  static_cast<std::size_t>(settings.plotBounds.getWidth()));
+}
+
 template <class T,
           typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
 auto automaticPlotBounds(PlotSettings<T>& settings, const std::vector<PlotData<T>>& data)
@@ -257,31 +430,34 @@ auto automaticPlotBounds(PlotSettings<T>& settings, const std::vector<PlotData<T
       yMin = std::numeric_limits<T>::max(), yMax = std::numeric_limits<T>::min();
     for (const auto& d: data)
     {
-        if (settings.type == PlotType::linear)
+        if (settings.type != PlotType::logarithmic)
         {
-            const auto xMinCandidate = d.xData.front();
+            const auto xMinCandidate = d.getXData().front();
             xMin = xMinCandidate < xMin ? xMinCandidate : xMin;
 
-            const auto xMaxCandidate = d.xData.back();
+            const auto xMaxCandidate = d.getXData().back();
             xMax = xMaxCandidate > xMax ? xMaxCandidate : xMax;
         }
         else
         {
-            const auto xMinCandidate = d.xData.front();
+            const auto xMinCandidate = d.getXData().front();
             xMin = std::clamp(xMinCandidate < xMin ? xMinCandidate : xMin,
                               static_cast<T>(10.),
                               static_cast<T>(30e10));
 
-            const auto xMaxCandidate = d.xData.back();
+            const auto xMaxCandidate = d.getXData().back();
             xMax = std::clamp(xMaxCandidate > xMax ? xMaxCandidate : xMax,
                               static_cast<T>(10.),
                               static_cast<T>(30e10));
         }
 
-        const auto yMinCandidate = *std::min_element(d.yData.begin(), d.yData.end());
+        const auto& yData = d.getYData();
+        const auto yMinCandidate =
+            toDisplayValue(*std::min_element(yData.begin(), yData.end()), settings);
         yMin = yMinCandidate < yMin ? yMinCandidate : yMin;
 
-        const auto yMaxCandidate = *std::max_element(d.yData.begin(), d.yData.end());
+        const auto yMaxCandidate =
+            toDisplayValue(*std::max_element(yData.begin(), yData.end()), settings);
         yMax = yMaxCandidate > yMax ? yMaxCandidate : yMax;
     }
 
@@ -291,21 +467,6 @@ auto automaticPlotBounds(PlotSettings<T>& settings, const std::vector<PlotData<T
     settings.yMax = settings.yMaxDefault.value_or(yMax);
 }
 
-template <typename T>
-static inline auto lin_to_db(T lin) -> T
-{
-    if (lin <= static_cast<T>(0.))
-        return static_cast<T>(MINUS_INF);
-    return static_cast<T>(20. * std::log10(static_cast<double>(lin)));
-}
-
-template <typename T>
-static inline void lin_to_db(std::vector<T>& lin)
-{
-    std::transform(
-        lin.begin(), lin.end(), lin.begin(), [](auto& item) { return lin_to_db(item); });
-}
-
 template <typename T>
 static auto warp(std::vector<T>& magnitude) -> std::vector<T>
 {
@@ -322,59 +483,9 @@ static auto warp(std::vector<T>& magnitude) -> std::vector<T>
     _1D::CubicSplineInterpolator<double> interp;
     interp.setData(N, n_lin.data(), magnitude.data());
 
-    std::for_each(n_log.begin(), n_log.end(), [&](auto& item) { item = interp(item); });
+    // the log spaced bins are ascending, so the interpolator can walk along the data
+    interp.batch_monotone(n_log.begin(), n_log.end(), n_log.begin());
 
     return n_log;
 }
-
-template <typename T>
-static auto smooth_warped(const std::vector<T>& warped, int num_fractions, bool hanning = true)
-    -> std::vector<T>
-{
-    auto N = warped.size();
-    std::vector<T> n_lin(N), n_log(N);
-    std::iota(n_lin.begin(), n_lin.end(), 1.);
-    std::iota(n_log.begin(), n_log.end(), 0.);
-    std::for_each(n_log.begin(),
-                  n_log.end(),
-                  [&](auto& item)
-                  { item = std::pow(N, item / static_cast<T>((N - 1))); });
-
-    // frequency bin spacing in octaves: log2(n_log[n]/n_log[n-1])
-    // Note: n_log[0] = 1
-    auto delta_n_old = std::log2(n_log[1]);
-    auto delta_n = std::log2(std::pow(N, 1. / static_cast<T>((N - 1))));
-    assert(delta_n_old == delta_n);
-
-    // width of the window in logarithmically spaced samples
-    // Note: Forcing the window to have an odd length increases the deviation
-    //       from the exact width, but makes sure that the delay introduced in
-    //       the convolution is integer and can be easily compensated
-    auto n_window = static_cast<int>(
-        2 * std::floor(1. / static_cast<double>(num_fractions * delta_n * 2)) + 1);
-
-    // generate window
-    std::vector<T> window(n_window, 1);
-    if (hanning)
-    {
-        hanning_window(window);
-    }
-    auto windowSum = std::reduce(window.begin(), window.end());
-
-    std::vector<T> tmpVec;
-    std::copy(warped.cbegin(), warped.cend(), std::back_inserter(tmpVec));
-
-    tmpVec.resize(warped.size() + n_window);
-
-    // convolve window
-    auto temp = convolve(window, tmpVec);
-    auto index = size_t(n_window / 2);
-    auto smoothed = std::vector<T>(warped.size());
-    for (size_t i = 0; i < warped.size(); ++i)
-    {
-        smoothed[i] = temp[index + i] / static_cast<T>(windowSum);
-    }
-
-    return smoothed;
-}
 } // namespace neo::plot
@@ -5,6 +5,8 @@ namespace neo::plot
 enum PlotType
 {
     linear,
-    logarithmic
+    logarithmic,
+    // linear time on the x-axis, logarithmic frequency on the y-axis
+    spectrogram
 };
 }
@@ -0,0 +1,149 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include "PlotData.h"
+#include "PlotSettings.h"
+
+namespace neo::plot
+{
+// The x range of linked plots, e.g. one plot per channel stacked above each other. A plot
+// that moves its view sets the range here and every other subscribed plot takes it over.
+// The linked plots are only marked dirty, so the whole group is painted together in the
+// next paint of the window instead of one plot after the other.
+//
+// Series with shared x and y arrays, e.g. the same recording shown in several plots, are
+// reduced by the first plot that draws them for a view and copied by the others. Shared
+// arrays are const, so a reduction stays valid as long as its arrays are alive.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class PlotViewModel
+{
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+        virtual void xRangeChanged(T xMin, T xMax) = 0;
+    };
+
+    void addListener(Listener* listener) { m_listeners.add(listener); }
+
+    void removeListener(Listener* listener) { m_listeners.remove(listener); }
+
+    // sets the x range of every listener but source, which already shows it
+    void setXRange(const T xMin, const T xMax, Listener* source = nullptr)
+    {
+        m_xRange = {xMin, xMax};
+        m_listeners.callExcluding(source,
+                                  [xMin, xMax](Listener& listener)
+                                  { listener.xRangeChanged(xMin, xMax); });
+    }
+
+    // nothing until a plot set it
+    [[nodiscard]] auto getXRange() const -> std::optional<std::pair<T, T>>
+    {
+        return m_xRange;
+    }
+
+    // start and end index, number of columns, points per column and how y is reduced
+    using ReductionKey =
+        std::tuple<std::size_t, std::size_t, std::size_t, std::size_t, bool, bool, bool>;
+
+    static auto getReductionKey(const PlotSettings<T>& settings,
+                                const PlotData<T>& data,
+                                const std::pair<std::size_t, std::size_t> range,
+                                const std::size_t numColumns,
+                                const std::size_t maxPointsPerColumn) -> ReductionKey
+    {
+        return {range.first,
+                range.second,
+                numColumns,
+                maxPointsPerColumn,
+                data.isWaveform,
+                settings.yAxisInDb,
+                settings.fastDbConversion};
+    }
+
+    // copies the reduction another plot made of data for key into it, false if there
+    // is none
+    auto copyReduction(PlotData<T>& data, const ReductionKey& key) const -> bool
+    {
+        if (!canShareReduction(data))
+        {
+            return false;
+        }
+        const auto it = m_reductions.find(data.sharedYData.get());
+        if (it == m_reductions.end() || it->second.key != key
+            || it->second.xData != data.sharedXData)
+        {
+            return false;
+        }
+
+        const auto& reduction = it->second;
+        const auto numColumns = std::get<2>(key);
+        std::copy_n(reduction.xReduced.begin(), numColumns, data.xDataReduced.begin());
+        std::copy_n(reduction.yReduced.begin(), numColumns, data.yDataReduced.begin());
+        if (data.isWaveform)
+        {
+            std::copy_n(reduction.yReducedWaveformMin.begin(),
+                        numColumns,
+                        data.yDataReducedWaveformMin.begin());
+        }
+        return true;
+    }
+
+    // keeps the reduction of data for key for the other plots
+    void storeReduction(const PlotData<T>& data, const ReductionKey& key)
+    {
+        if (!canShareReduction(data))
+        {
+            return;
+        }
+
+        // drops the reductions of arrays no series uses any more
+        for (auto it = m_reductions.begin(); it != m_reductions.end();)
+        {
+            const auto unused = it->second.yData.use_count() == 1;
+            it = unused ? m_reductions.erase(it) : std::next(it);
+        }
+
+        const auto numColumns = static_cast<long>(std::get<2>(key));
+        auto& reduction = m_reductions[data.sharedYData.get()];
+        reduction.xData = data.sharedXData;
+        reduction.yData = data.sharedYData;
+        reduction.key = key;
+        reduction.xReduced.assign(data.xDataReduced.begin(),
+                                  data.xDataReduced.begin() + numColumns);
+        reduction.yReduced.assign(data.yDataReduced.begin(),
+                                  data.yDataReduced.begin() + numColumns);
+        if (data.isWaveform)
+        {
+            reduction.yReducedWaveformMin.assign(
+                data.yDataReducedWaveformMin.begin(),
+                data.yDataReducedWaveformMin.begin() + numColumns);
+        }
+    }
+
+    static auto canShareReduction(const PlotData<T>& data) -> bool
+    {
+        return data.sharedXData != nullptr && data.sharedYData != nullptr;
+    }
+
+private:
+    struct Reduction
+    {
+        // held, so the address of an array is not reused while its reduction is kept
+        std::shared_ptr<const std::vector<T>> xData, yData;
+        ReductionKey key;
+        std::vector<T> xReduced, yReduced, yReducedWaveformMin;
+    };
+
+    juce::ListenerList<Listener> m_listeners;
+    std::optional<std::pair<T, T>> m_xRange;
+    // the last reduction of every shared y array
+    std::map<const std::vector<T>*, Reduction> m_reductions;
+};
+} // namespace neo::plot
@@ -0,0 +1,52 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "PlotTools.h"
+
+namespace neo::plot
+{
+// Logarithmically warped copies of shared x and y arrays, one per source array, shared
+// by all plots through a juce::SharedResourcePointer. The channels of a recording keep
+// sharing one warped x array, and linked logarithmic plots of the same series show the
+// same warped y array, so the view model shares their reductions too. Only weak
+// pointers are kept, a warped array lives as long as a series shows it.
+template <class T,
+          typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+class PlotWarpCache
+{
+public:
+    auto getWarped(const std::shared_ptr<const std::vector<T>>& source)
+        -> std::shared_ptr<const std::vector<T>>
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        // drops the entries of arrays no series uses any more
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            const auto unused = it->second.source.expired() || it->second.warped.expired();
+            it = unused ? m_entries.erase(it) : std::next(it);
+        }
+
+        auto& entry = m_entries[source.get()];
+        auto warped = entry.warped.lock();
+        if (warped == nullptr || entry.source.lock() != source)
+        {
+            auto values = *source;
+            warped = std::make_shared<const std::vector<T>>(warp(values));
+            entry = {source, warped};
+        }
+        return warped;
+    }
+
+private:
+    struct Entry
+    {
+        std::weak_ptr<const std::vector<T>> source, warped;
+    };
+
+    std::mutex m_mutex;
+    std::map<const std::vector<T>*, Entry> m_entries;
+};
+} // namespace neo::plot